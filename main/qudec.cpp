@@ -41,6 +41,11 @@ main(int argc, char* argv[])
     std::string experiment;
     std::string generated_stim_output_file;
     std::string decoder;
+    int64_t     b5_table_mb;
+    bool        b5_sparse;
+    int64_t     b5_knn;
+    int64_t     b5_threads;
+    int64_t     b5_parallel_hw;
 
     ARGPARSE()
         .optional("-f", "--stim-file", "stim file", stim_file, "")
@@ -66,7 +71,13 @@ main(int argc, char* argv[])
 
         // decoder:
         .optional("", "--decoder", "decoder to use", decoder, "pymatching")
+        .optional("", "--b5-table-mb", "BLOSSOM5 distance table memory budget in MB (0 = disabled)", b5_table_mb, 256)
+        .optional("", "--b5-sparse", "BLOSSOM5 uses a sparse matching graph with per-defect boundary copies", b5_sparse, false)
+        .optional("", "--b5-knn", "BLOSSOM5 sparse matching: also connect each defect to its k nearest defects", b5_knn, 0)
+        .optional("", "--b5-threads", "BLOSSOM5 threads per decode for large shots", b5_threads, 1)
+        .optional("", "--b5-parallel-hw", "BLOSSOM5 minimum hamming weight for using multiple threads", b5_parallel_hw, 64)
         .optional("-dd", "--debug-decoder", "enable decoder debug output", GL_DEBUG_DECODER, false)
+        .optional("", "--dg-cache-dir", "decoding graph cache directory (empty = disabled)", GL_DG_CACHE_DIR, "")
         .parse(argc, argv);
 
     // update error and timing based on value of p
@@ -124,12 +135,30 @@ main(int argc, char* argv[])
     }
 
     DECODER_EVAL_CONFIG eval_conf{.stop_at_k_errors = static_cast<uint64_t>(num_errors)};
+    if (stim_file.empty() && (experiment == "sc_memory_x" || experiment == "sc_memory_z"))
+        eval_conf.observable_basis = (experiment == "sc_memory_x") ? "X" : "Z";
 
     DECODER_STATS stats;
     if (decoder == "pymatching")
         stats = eval_decoder<PYMATCHING>(circuit, num_trials, eval_conf, circuit);
     else if (decoder == "blossom5")
-        stats = eval_decoder<BLOSSOM5>(circuit, num_trials, eval_conf, circuit);
+    {
+        BLOSSOM5::options b5_opts;
+        b5_opts.distance_table_max_bytes = static_cast<size_t>(b5_table_mb) << 20;
+        b5_opts.sparse_matching = b5_sparse;
+        b5_opts.sparse_knn = static_cast<size_t>(b5_knn);
+        b5_opts.num_decode_threads = static_cast<size_t>(b5_threads);
+        b5_opts.parallel_hamming_weight_threshold = static_cast<size_t>(b5_parallel_hw);
+
+        BLOSSOM5 b5(circuit, b5_opts);
+        stats = benchmark_decoder(circuit, b5, num_trials, eval_conf);
+
+        if (const auto* table = b5.get_distance_table(); table != nullptr)
+        {
+            print_stat(std::cout, "DISTANCE_TABLE_FULL", table->is_full());
+            print_stat(std::cout, "DISTANCE_TABLE_MB", fpdiv(table->memory_bytes(), 1024*1024));
+        }
+    }
     else
         throw std::runtime_error("invalid decoder: " + decoder);
 
@@ -140,6 +169,7 @@ main(int argc, char* argv[])
     print_stat(std::cout, "LOGICAL_ERRORS", stats.errors);
     print_stat(std::cout, "TRIALS", stats.trials);
     print_stat(std::cout, "LOGICAL_ERROR_RATE", ler);
+    print_observable_stats(std::cout, stats, eval_conf);
     print_stat(std::cout, "MEAN_TIME_US", mean_time_us);
     print_stat(std::cout, "MEAN_TIME_US_NONTRIVIAL", mean_time_us_nontrivial);
 
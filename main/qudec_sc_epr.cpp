@@ -36,6 +36,60 @@ write_stim_circuit_to_file(std::string_view filename, const stim::Circuit& circu
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Consistency check for `HIER_PYMATCHING` with three tiers: the inner circuit (sliding), the outer circuit
+ * (sliding), and the outer circuit again (global). Both sliding tiers escalate their boundary matches. Every
+ * shot is decoded sequentially and pipelined, and the check fails if the two predictions differ.
+ * */
+
+class HIER_CONSISTENCY_CHECK
+{
+private:
+    HIER_PYMATCHING sequential;
+    HIER_PYMATCHING pipelined;
+public:
+    HIER_CONSISTENCY_CHECK(const gen::SC_EPR_GEN_OUTPUT& gen_out, size_t code_distance)
+        :sequential(gen_out.circuit, tiers(gen_out, code_distance), {gen_out.num_hw1_rounds_per_super_round+1}),
+        pipelined(gen_out.circuit, 
+                    tiers(gen_out, code_distance), 
+                    {gen_out.num_hw1_rounds_per_super_round+1}, 
+                    HIER_PYMATCHING::options{.pipelined=true})
+    {
+    }
+
+    DECODER_RESULT 
+    decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm)
+    {
+        auto result = sequential.decode(dets, debug_strm);
+        auto pipelined_result = pipelined.decode(dets, debug_strm);
+        if (result.flipped_observables != pipelined_result.flipped_observables)
+            throw std::runtime_error("HIER_CONSISTENCY_CHECK: sequential and pipelined predictions differ");
+        return result;
+    }
+private:
+    static std::vector<HIER_PYMATCHING::tier> 
+    tiers(const gen::SC_EPR_GEN_OUTPUT& gen_out, size_t code_distance)
+    {
+        return 
+        {
+            HIER_PYMATCHING::tier{.circuit=&gen_out.first_pass,
+                                    .round_depth=2,
+                                    .commit_size=code_distance,
+                                    .window_size=2*code_distance,
+                                    .escalate_boundary_matches=true},
+            HIER_PYMATCHING::tier{.circuit=&gen_out.second_pass,
+                                    .round_depth=1,
+                                    .commit_size=code_distance,
+                                    .window_size=2*code_distance,
+                                    .escalate_boundary_matches=true},
+            HIER_PYMATCHING::tier{.circuit=&gen_out.second_pass, .round_depth=1}
+        };
+    }
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
 int
 main(int argc, char* argv[])
 {
@@ -55,6 +109,8 @@ main(int argc, char* argv[])
     int64_t eval_mode;  // 0 = use pymatching on global,
                         // 1 = use dual pass
                         // -1 = evaluate single hardware EPR only.
+                        // 2 = three tier sequential vs. pipelined check
+    bool    pipelined;
 
     ARGPARSE()
         .optional("-d", "--code-distance", "code distance", code_distance, 3)
@@ -73,9 +129,11 @@ main(int argc, char* argv[])
         // decoding:
         .optional("-dd", "--debug-decoder", "set flag debug decoder flag", GL_DEBUG_DECODER, false)
         .optional("-v", "--verbose", "set flag for verbose EPR_PYMATCHING", GL_EPR_PYMATCHING_VERBOSE, false)
+        .optional("", "--pipelined", "dual pass: stream the inner pass into a sliding outer pass (two threads)", pipelined, false)
+        .optional("", "--dg-cache-dir", "decoding graph cache directory (empty = disabled)", GL_DG_CACHE_DIR, "")
 
         // other:
-        .optional("-m", "--mode", "0 = global, 1 = dual pass, -1 = single hardware EPR", eval_mode, 0)
+        .optional("-m", "--mode", "0 = global, 1 = dual pass, -1 = single hardware EPR, 2 = three tier consistency check", eval_mode, 0)
     
         .parse(argc, argv);
 
@@ -101,6 +159,8 @@ main(int argc, char* argv[])
     write_stim_circuit_to_file("second_pass.stim.out", gen_out.second_pass);
 
     DECODER_EVAL_CONFIG eval_config{.stop_at_k_errors = static_cast<uint64_t>(num_errors)};
+    if (do_memory_experiment)
+        eval_config.observable_basis = "X";
     DECODER_STATS stats;
     if (eval_mode == 0)
     {
@@ -117,8 +177,8 @@ main(int argc, char* argv[])
                                 gen_out.first_pass,
                                 gen_out.second_pass,
                                 code_distance,
-                                gen_out.num_super_rounds,
-                                gen_out.num_hw1_rounds_per_super_round);
+                                gen_out.num_hw1_rounds_per_super_round,
+                                EPR_PYMATCHING::options{.pipelined=pipelined});
                                 
         stats = benchmark_decoder(gen_out.circuit, decoder, num_trials,
                                 [&reference_decoder] 
@@ -146,6 +206,23 @@ main(int argc, char* argv[])
 
                                     return mismatch;
                                 }, eval_config);
+
+        // tier 0 is the inner decoder, and tier 1 is the outer decoder:
+        const auto& tier_stats = decoder.get_tier_stats();
+        std::cout << "======================== TIER STATISTICS ==========================\n";
+        for (size_t t = 0; t < tier_stats.size(); t++)
+        {
+            const std::string prefix = "TIER" + std::to_string(t);
+            print_stat(std::cout, prefix + "_MEAN_BUSY_US", fpdiv(tier_stats[t].busy_ns, 1000*stats.trials));
+            print_stat(std::cout, prefix + "_MEAN_TAIL_US", fpdiv(tier_stats[t].tail_ns, 1000*stats.trials));
+            if (t+1 < tier_stats.size())
+                print_stat(std::cout, prefix + "_ESCALATED_PER_TRIAL", fpdiv(tier_stats[t].escalated, stats.trials));
+        }
+    }
+    else if (eval_mode == 2)
+    {
+        HIER_CONSISTENCY_CHECK decoder(gen_out, code_distance);
+        stats = benchmark_decoder(gen_out.circuit, decoder, num_trials, eval_config);
     }
 
     // Calculate and print results
@@ -158,6 +235,7 @@ main(int argc, char* argv[])
     print_stat(std::cout, "TRIALS", stats.trials);
     print_stat(std::cout, "TRIVIAL_TRIALS", stats.trivial_trials);
     print_stat(std::cout, "LOGICAL_ERROR_RATE", ler);
+    print_observable_stats(std::cout, stats, eval_config);
     print_stat(std::cout, "MEAN_TIME_US", mean_time_us);
     print_stat(std::cout, "MEAN_TIME_US_NONTRIVIAL", mean_time_us_nontrivial);
     std::cout << "===============================================================\n";
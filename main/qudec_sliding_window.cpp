@@ -7,6 +7,7 @@
 
 #include "argparse.h"
 #include "decoder_eval.h"
+#include "decoder/sliding_blossom5.h"
 #include "decoder/surface_code.h"
 #include "gen.h"
 #include "qudec_common.h"
@@ -53,6 +54,15 @@ main(int argc, char* argv[])
     double e_idle;
 
     std::string experiment;
+    std::string decoder_name;
+    bool        parallel_windows;
+    bool        pipelined_windows;
+    bool        adaptive_windows;
+    int64_t     adaptive_quiet_rounds;
+    int64_t     adaptive_min_buffer;
+    int64_t     num_threads;
+    bool        b5_cold;
+    int64_t     b5_table_mb;
     std::string generated_stim_output_file;
     std::string decoder_circuit_output_file;
 
@@ -77,7 +87,17 @@ main(int argc, char* argv[])
         .optional("", "--experiment", "experiment name", experiment, "sc_memory_z")
 
         // decoder:
+        .optional("", "--decoder", "window decoder (pymatching or blossom5)", decoder_name, "pymatching")
+        .optional("", "--parallel-windows", "pymatching: decode the windows in two parallel layers", parallel_windows, false)
+        .optional("", "--pipelined", "pymatching: match the next window speculatively on a second thread", pipelined_windows, false)
+        .optional("", "--threads", "pymatching: threads for `--parallel-windows`", num_threads, 1)
+        .optional("", "--adaptive", "pymatching: adapt the commit/window size to the syndrome", adaptive_windows, false)
+        .optional("", "--adaptive-quiet-rounds", "pymatching: quiet rounds that end a cluster (0 = commit size)", adaptive_quiet_rounds, 0)
+        .optional("", "--adaptive-min-buffer", "pymatching: buffer when the commit boundary is quiet (0 = half)", adaptive_min_buffer, 0)
+        .optional("", "--b5-cold", "blossom5: solve every window from scratch (no warm start)", b5_cold, false)
+        .optional("", "--b5-table-mb", "blossom5: distance table memory budget in MB (0 = disabled)", b5_table_mb, 256)
         .optional("-dd", "--debug-decoder", "enable decoder debug output", GL_DEBUG_DECODER, false)
+        .optional("", "--dg-cache-dir", "decoding graph cache directory (empty = disabled)", GL_DG_CACHE_DIR, "")
         .parse(argc, argv);
 
     if (commit_size < 0)
@@ -110,7 +130,8 @@ main(int argc, char* argv[])
                                 .set_e_idle(e_idle);
 
     // Generate the full circuit (r rounds) for syndrome generation
-    const int64_t window_size{2*commit_size};
+    // with parallel windows, the buffer is split between both sides of the core (so it is `commit_size` on each side):
+    const int64_t window_size{(parallel_windows ? 3 : 2)*commit_size};
     int64_t detectors_per_round;
 
     stim::Circuit full_circuit, decoder_circuit;
@@ -123,16 +144,18 @@ main(int argc, char* argv[])
     }
 
     PYMATCHING reference_decoder(full_circuit);
-    SLIDING_PYMATCHING decoder(decoder_circuit, commit_size, window_size, detectors_per_round, num_rounds);
 
     DECODER_EVAL_CONFIG eval_conf
     {
         .batch_size = 8192,
         .enable_clock = true,
         .seed = 0,
-        .stop_at_k_errors = num_errors
+        .stop_at_k_errors = num_errors,
+        .observable_basis = (experiment == "sc_memory_x") ? "X" : "Z"
     };
-    auto stats = benchmark_decoder(full_circuit, decoder, num_trials,
+    auto _benchmark = [&] (auto& decoder)
+    {
+        return benchmark_decoder(full_circuit, decoder, num_trials,
                                 [&reference_decoder] 
                                 (syndrome_ref dets, syndrome_ref, syndrome_ref pred, std::ostream& debug_strm)
                                 {
@@ -158,6 +181,61 @@ main(int argc, char* argv[])
 
                                     return mismatch;
                                 }, eval_conf);
+    };
+
+    DECODER_STATS stats;
+    if (decoder_name == "pymatching")
+    {
+        SLIDING_PYMATCHING::options pym_opts;
+        pym_opts.parallel_windows = parallel_windows;
+        pym_opts.num_threads = static_cast<size_t>(num_threads);
+        pym_opts.pipelined_windows = pipelined_windows;
+        pym_opts.adaptive_windows = adaptive_windows;
+        pym_opts.adaptive_quiet_rounds = static_cast<size_t>(adaptive_quiet_rounds);
+        pym_opts.adaptive_min_buffer = static_cast<size_t>(adaptive_min_buffer);
+
+        SLIDING_PYMATCHING decoder(decoder_circuit, commit_size, window_size, detectors_per_round, num_rounds, pym_opts);
+        stats = _benchmark(decoder);
+
+        const auto& ws = decoder.get_window_stats();
+        if (ws.windows > 0)
+        {
+            std::cout << "======================== WINDOW STATISTICS ========================\n";
+            print_stat(std::cout, "WINDOWS_PER_TRIAL", fpdiv(ws.windows, stats.trials));
+            print_stat(std::cout, "MEAN_COMMIT_ROUNDS", fpdiv(ws.commit_rounds, ws.windows));
+            print_stat(std::cout, "MEAN_WINDOW_ROUNDS", fpdiv(ws.window_rounds, ws.windows));
+            print_stat(std::cout, "MEAN_WINDOW_TIME_US", fpdiv(ws.flood_ns + ws.path_ns + ws.commit_ns, 1000*ws.windows));
+            print_stat(std::cout, "MEAN_WINDOW_FLOOD_TIME_US", fpdiv(ws.flood_ns, 1000*ws.windows));
+            print_stat(std::cout, "MEAN_WINDOW_PATH_TIME_US", fpdiv(ws.path_ns, 1000*ws.windows));
+            print_stat(std::cout, "MEAN_WINDOW_COMMIT_TIME_US", fpdiv(ws.commit_ns, 1000*ws.windows));
+            if (adaptive_windows)
+            {
+                print_stat(std::cout, "ISOLATED_WINDOWS", ws.isolated_windows);
+                print_stat(std::cout, "GROWN_BUFFERS", ws.grown_buffers);
+            }
+            if (pipelined_windows)
+            {
+                // an applied speculative window was matched alongside the window before it, so it is off
+                // the critical path:
+                print_stat(std::cout, "SPECULATED_WINDOWS", ws.speculated_windows);
+                print_stat(std::cout, "SPECULATION_HIT_RATE", fpdiv(ws.speculation_hits, ws.speculated_windows));
+                print_stat(std::cout, "CRITICAL_PATH_WINDOWS_PER_TRIAL", fpdiv(ws.windows - ws.speculation_hits, stats.trials));
+            }
+        }
+    }
+    else if (decoder_name == "blossom5")
+    {
+        SLIDING_BLOSSOM5::options b5_opts;
+        b5_opts.warm_start = !b5_cold;
+        b5_opts.window_options.distance_table_max_bytes = static_cast<size_t>(b5_table_mb) << 20;
+
+        SLIDING_BLOSSOM5 decoder(decoder_circuit, commit_size, window_size, detectors_per_round, num_rounds, b5_opts);
+        stats = _benchmark(decoder);
+    }
+    else
+    {
+        throw std::runtime_error("invalid decoder: " + decoder_name);
+    }
 
     double ler = fpdiv(stats.errors, stats.trials);
     double mean_time_us = fpdiv(stats.total_time_us, stats.trials);
@@ -168,6 +246,7 @@ main(int argc, char* argv[])
     print_stat(std::cout, "TRIALS", stats.trials);
     print_stat(std::cout, "TRIVIAL_TRIALS", stats.trivial_trials);
     print_stat(std::cout, "LOGICAL_ERROR_RATE", ler);
+    print_observable_stats(std::cout, stats, eval_conf);
     print_stat(std::cout, "MEAN_TIME_US", mean_time_us);
     print_stat(std::cout, "MEAN_TIME_US_NONTRIVIAL", mean_time_us_nontrivial);
     std::cout << "===============================================================\n";
@@ -8,6 +8,7 @@
 
 #include "decoding_graph.h"
 
+#include <stim/mem/simd_bit_table.h>
 #include <stim/mem/simd_bits.h>
 
 #include <unordered_set>
@@ -17,6 +18,7 @@
 
 using syndrome_type = stim::simd_bits<stim::MAX_BITWORD_WIDTH>;
 using syndrome_ref = stim::simd_bits_range_ref<stim::MAX_BITWORD_WIDTH>;
+using syndrome_table_type = stim::simd_bit_table<stim::MAX_BITWORD_WIDTH>;
 
 constexpr size_t DEFAULT_OBS_BIT_WIDTH{256};
 
@@ -28,4 +30,23 @@ struct DECODER_RESULT
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Syndrome scans shared by the sliding window decoders. Syndromes are sparse, so defects are
+ * extracted a word at a time, and windows use per-round defect counts to skip empty rounds.
+ * */
+
+// calls `cb(i)` for each defect `i` in [begin, end):
+template <class CALLBACK> void for_each_defect(syndrome_ref, size_t begin, size_t end, const CALLBACK&);
+
+// number of defects in each round (plus one empty round past the end):
+inline std::vector<uint32_t> count_defects_by_round(syndrome_ref, size_t detectors_per_round);
+
+// first round at or after `r` with a defect (`defects_by_round.size()` if there is none):
+inline size_t next_round_with_defects(const std::vector<uint32_t>& defects_by_round, size_t r);
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#include "common.tpp"
+
 #endif  // DECODER_COMMON_h
@@ -0,0 +1,50 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#include <algorithm>
+#include <bit>
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+template <class CALLBACK> void
+for_each_defect(syndrome_ref syndrome, size_t begin, size_t end, const CALLBACK& cb)
+{
+    end = std::min(end, syndrome.num_bits_padded());
+    for (size_t w = begin/64; 64*w < end; w++)
+    {
+        uint64_t word = syndrome.u64[w];
+        if (w == begin/64)
+            word &= ~uint64_t{0} << (begin & 63);
+        if (64*(w+1) > end)
+            word &= (uint64_t{1} << (end & 63)) - 1;
+
+        for (; word; word &= word-1)
+            cb(64*w + std::countr_zero(word));
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+inline std::vector<uint32_t>
+count_defects_by_round(syndrome_ref syndrome, size_t detectors_per_round)
+{
+    std::vector<uint32_t> defects_by_round(syndrome.num_bits_padded()/detectors_per_round + 1, 0);
+    for_each_defect(syndrome, 0, syndrome.num_bits_padded(),
+            [&] (size_t i) { defects_by_round[i / detectors_per_round]++; });
+    return defects_by_round;
+}
+
+inline size_t
+next_round_with_defects(const std::vector<uint32_t>& defects_by_round, size_t r)
+{
+    while (r < defects_by_round.size() && defects_by_round[r] == 0)
+        r++;
+    return r;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
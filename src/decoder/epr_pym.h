@@ -6,11 +6,9 @@
 #ifndef DECODER_EPR_PYM_h
 #define DECODER_EPR_PYM_h
 
-#include "decoder/sliding_pym.h"
-#include "decoder/surface_code.h"
+#include "decoder/hier_pym.h"
 
 #include <memory>
-#include <optional>
 
 extern bool GL_EPR_PYMATCHING_VERBOSE;
 
@@ -30,82 +28,44 @@ extern bool GL_EPR_PYMATCHING_VERBOSE;
  * Any detectors that the first decoder maps to the boundary are
  * retried by the second decoder.
  *
- * The first decoder is a sliding window decoder. The second is not.
+ * The first decoder is a sliding window decoder. The second matches all super rounds at once,
+ * unless `pipelined` is set: then both tiers stream, and run concurrently on two threads, and the
+ * second decoder is a sliding window decoder over super rounds (`code_distance` super rounds are
+ * committed per window, with a buffer of the same size).
+ *
+ * This is a two tier `HIER_PYMATCHING`: the inner tier is indexed by (super round, sub round), and the
+ * outer tier by super round.
  * */
 
 class EPR_PYMATCHING
 {
 public:
-    constexpr static size_t BASE_DETECTOR_IDX{2};
-    constexpr static size_t SUPER_ROUND_IDX{3};
-    constexpr static size_t SUB_ROUND_IDX{4};
-
-    struct detector_info
+    struct options
     {
-        GRAPH_COMPONENT_ID inner_id{-1};
-        GRAPH_COMPONENT_ID outer_id;
+        bool pipelined{false};
     };
-
-    using detector_info_map_type = std::unordered_map<GRAPH_COMPONENT_ID, detector_info>;
-
-    const stim::Circuit& global_circuit;
-    const stim::Circuit& inner_circuit;
-    const stim::Circuit& outer_circuit;
 private:
-    size_t num_super_rounds;
-    size_t num_sub_rounds_per_super_round;
-    
-    size_t outer_detectors_per_round{};
-    size_t inner_detectors_per_round{};
-    size_t total_detectors_per_super_round;
-
-    std::unique_ptr<SLIDING_PYMATCHING> dec_inner;
-    std::unique_ptr<PYMATCHING>         dec_outer;
-
-    detector_info_map_type m_detector_info;
+    std::unique_ptr<HIER_PYMATCHING> dec;
 
-    std::unordered_set<GRAPH_COMPONENT_ID> do_not_commit_boundary_edges_set;
+    const options opts;
 public:
     EPR_PYMATCHING(const stim::Circuit& global,
-                    const stim::Circuit& inner, 
+                    const stim::Circuit& inner,
                     const stim::Circuit& outer,
                     size_t code_distance,
-                    size_t num_super_rounds,
                     size_t num_sub_rounds_per_super_round);
+    EPR_PYMATCHING(const stim::Circuit& global,
+                    const stim::Circuit& inner,
+                    const stim::Circuit& outer,
+                    size_t code_distance,
+                    size_t num_sub_rounds_per_super_round,
+                    options);
 
     DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm);
-private:
-    std::optional<size_t> get_inner_syndrome_detector_idx(size_t global_detector_idx);
-    size_t get_outer_syndrome_detector_idx(size_t global_detector_idx);
-};
 
-/////////////////////////////////////////////////////
-/////////////////////////////////////////////////////
-
-void concat_debug_strm(std::ostream& target, std::stringstream& source, size_t tab_count);
-
-/////////////////////////////////////////////////////
-/////////////////////////////////////////////////////
-
-// helper function for initializing `m_detector_info`:
-template <class UPDATE_CALLBACK> void
-read_first_round_of_detectors(const stim::Circuit& circ, const UPDATE_CALLBACK& cb)
-{
-    // only need first round of syndromes from each circuit:
-    for (size_t i = 0; i < circ.count_detectors(); i++)
-    {
-        const auto coords = circ.coords_of_detector(i);
-        size_t overall_round = static_cast<size_t>(coords[1]),
-               base = static_cast<size_t>(coords[EPR_PYMATCHING::BASE_DETECTOR_IDX]),
-               super_round_idx = static_cast<size_t>(coords[EPR_PYMATCHING::SUPER_ROUND_IDX]),
-               sub_round_idx = static_cast<size_t>(coords[EPR_PYMATCHING::SUB_ROUND_IDX]);
-        
-        if (overall_round > 0)
-            continue;
-
-        cb(i, base, super_round_idx, sub_round_idx);
-    }
-}
+    // tier 0 is the inner decoder, and tier 1 is the outer decoder:
+    const std::vector<HIER_PYMATCHING::tier_stats>& get_tier_stats() const { return dec->get_tier_stats(); }
+};
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
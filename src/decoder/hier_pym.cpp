@@ -0,0 +1,467 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#include "decoder/hier_pym.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+extern bool GL_DEBUG_DECODER;
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+HIER_PYMATCHING::HIER_PYMATCHING(const stim::Circuit& global,
+                                    std::vector<tier> _tiers,
+                                    std::vector<size_t> _sub_rounds_per_round)
+    :HIER_PYMATCHING(global, std::move(_tiers), std::move(_sub_rounds_per_round), options{})
+{
+}
+
+HIER_PYMATCHING::HIER_PYMATCHING(const stim::Circuit& global,
+                                    std::vector<tier> _tiers,
+                                    std::vector<size_t> _sub_rounds_per_round,
+                                    options _opts)
+    :sub_rounds_per_round(std::move(_sub_rounds_per_round)),
+    stats(_tiers.size()),
+    opts(_opts)
+{
+    const size_t num_tiers = _tiers.size();
+    if (num_tiers == 0 || num_tiers > std::numeric_limits<uint8_t>::max())
+        throw std::runtime_error("HIER_PYMATCHING: unsupported number of tiers: " + std::to_string(num_tiers));
+
+    // read the detector of each check in each tier:
+    std::vector<std::unordered_map<size_t, GRAPH_COMPONENT_ID>> check_ids(num_tiers);
+    tiers.resize(num_tiers);
+    for (size_t t = 0; t < num_tiers; t++)
+    {
+        auto& ts = tiers[t];
+        ts.cfg = _tiers[t];
+        if (ts.cfg.round_depth == 0 || ts.cfg.round_depth > sub_rounds_per_round.size()+1)
+            throw std::runtime_error("HIER_PYMATCHING: tier " + std::to_string(t) + " has an invalid round depth");
+        const bool escalates = ts.cfg.escalate_boundary_matches || !ts.cfg.escalate_boundary_bases.empty();
+        if (escalates && ts.cfg.commit_size == 0)
+            throw std::runtime_error("HIER_PYMATCHING: tier " + std::to_string(t) + " matches globally, so it cannot escalate");
+        if (escalates && t+1 == num_tiers)
+            throw std::runtime_error("HIER_PYMATCHING: tier " + std::to_string(t) + " is the last tier, so it cannot escalate");
+
+        read_first_round_of_detectors(*ts.cfg.circuit,
+                [&ids=check_ids[t], &ts, t] (auto d, auto base)
+                {
+                    if (ids.count(base))
+                        throw std::runtime_error("HIER_PYMATCHING: duplicate base detector in tier " + std::to_string(t) + ": " + std::to_string(base));
+                    ids[base] = d;
+                    ts.detectors_per_round++;
+                });
+
+        if (t == 0)
+            continue;
+        for (const auto& [base, d] : check_ids[t-1])
+        {
+            if (!check_ids[t].count(base))
+            {
+                throw std::runtime_error("HIER_PYMATCHING: no detector in tier " + std::to_string(t)
+                                            + " for base: " + std::to_string(base));
+            }
+        }
+    }
+
+    // route each detector of the global circuit. `coords_of_detector` walks the circuit, so all coordinates are
+    // read in one pass:
+    const size_t n = global.count_detectors();
+    std::set<uint64_t> all_detectors;
+    for (size_t d = 0; d < n; d++)
+        all_detectors.insert(all_detectors.end(), d);
+    const auto coords_by_detector = global.get_detector_coordinates(all_detectors);
+
+    auto _tier_idx = [&] (size_t t, size_t base, const std::vector<double>& coords) -> size_t
+    {
+        const size_t depth = tiers[t].cfg.round_depth;
+        size_t r = static_cast<size_t>(coords[FIRST_ROUND_IDX]);
+        for (size_t j = 1; j < depth; j++)
+            r = r*sub_rounds_per_round[j-1] + static_cast<size_t>(coords[FIRST_ROUND_IDX+j]);
+        return check_ids[t].at(base) + tiers[t].detectors_per_round*r;
+    };
+
+    auto _home_tier = [&] (size_t base) -> size_t
+    {
+        for (size_t t = 0; t < num_tiers; t++)
+            if (check_ids[t].count(base))
+                return t;
+        throw std::runtime_error("HIER_PYMATCHING: no tier has base: " + std::to_string(base));
+    };
+
+    // (1) compute the number of rounds of each tier (the detectors of the global circuit may go past the rounds
+    //      of the tier circuits, which are only window circuits):
+    home_tier.assign(n, 0);
+    home_idx.assign(n, 0);
+    for (const auto& [d, coords] : coords_by_detector)
+    {
+        const size_t base = static_cast<size_t>(coords[BASE_DETECTOR_IDX]),
+                     h = _home_tier(base);
+        home_tier[d] = h;
+        home_idx[d] = _tier_idx(h, base, coords);
+        for (size_t t = h; t < num_tiers; t++)
+        {
+            auto& ts = tiers[t];
+            ts.num_rounds = std::max(ts.num_rounds, _tier_idx(t, base, coords)/ts.detectors_per_round + 1);
+        }
+    }
+
+    // (2) escalation tables:
+    for (size_t t = 0; t+1 < num_tiers; t++)
+        tiers[t].next_tier_idx.assign(tiers[t].num_rounds*tiers[t].detectors_per_round, NO_IDX);
+    for (size_t t = 1; t < num_tiers; t++)
+        tiers[t].ready_at.assign(tiers[t].num_rounds, 0);
+
+    for (const auto& [d, coords] : coords_by_detector)
+    {
+        const size_t base = static_cast<size_t>(coords[BASE_DETECTOR_IDX]);
+        for (size_t t = home_tier[d]; t+1 < num_tiers; t++)
+        {
+            const size_t i = _tier_idx(t, base, coords),
+                         j = _tier_idx(t+1, base, coords),
+                         s = j / tiers[t+1].detectors_per_round;
+            tiers[t].next_tier_idx[i] = j;
+            tiers[t+1].ready_at[s] = std::max(tiers[t+1].ready_at[s], i/tiers[t].detectors_per_round + 1);
+        }
+    }
+
+    // commit policies (the boundary matches of each tier's `escalate_boundary_bases` are left uncommitted):
+    for (auto& ts : tiers)
+        ts.dopts.do_not_commit_any_boundary_edges = ts.cfg.escalate_boundary_matches;
+
+    for (const auto& [d, coords] : coords_by_detector)
+    {
+        const size_t base = static_cast<size_t>(coords[BASE_DETECTOR_IDX]);
+        for (size_t t = home_tier[d]; t < num_tiers; t++)
+        {
+            if (tiers[t].cfg.escalate_boundary_bases.count(base))
+                tiers[t].dopts.do_not_commit_boundary(_tier_idx(t, base, coords));
+        }
+    }
+
+    // rounds are handed off in order, so a round is only ready once the rounds before it are:
+    for (size_t t = 1; t < num_tiers; t++)
+    {
+        auto& ready_at = tiers[t].ready_at;
+        for (size_t s = 1; s < ready_at.size(); s++)
+            ready_at[s] = std::max(ready_at[s], ready_at[s-1]);
+    }
+
+    // decoders:
+    for (auto& ts : tiers)
+    {
+        if (ts.cfg.commit_size > 0)
+        {
+            ts.sliding = std::make_unique<SLIDING_PYMATCHING>(*ts.cfg.circuit,
+                                                            ts.cfg.commit_size,
+                                                            ts.cfg.window_size,
+                                                            ts.detectors_per_round,
+                                                            ts.num_rounds);
+        }
+        else
+        {
+            ts.global = std::make_unique<PYMATCHING>(*ts.cfg.circuit);
+        }
+    }
+
+    if (opts.pipelined && num_tiers > 1)
+        thread_pool = std::make_unique<THREAD_POOL>(num_tiers);
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+DECODER_RESULT
+HIER_PYMATCHING::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm)
+{
+    std::vector<syndrome_type> syndromes;
+    syndromes.reserve(tiers.size());
+    for (const auto& ts : tiers)
+    {
+        auto& s = syndromes.emplace_back(ts.num_rounds*ts.detectors_per_round);
+        s.clear();
+    }
+
+    for (auto d : dets)
+        syndromes[home_tier[d]][home_idx[d]] ^= 1;
+
+    if (GL_DEBUG_DECODER)
+    {
+        for (size_t t = 0; t < tiers.size(); t++)
+        {
+            debug_strm << "tier " << t << " syndrome (bit count = " << syndromes[t].num_bits_padded() << ") =";
+            for (size_t i = 0; i < syndromes[t].num_bits_padded(); i++)
+                if (syndromes[t][i])
+                    debug_strm << " " << i;
+            debug_strm << "\n";
+        }
+    }
+
+    return (opts.pipelined && tiers.size() > 1)
+                ? decode_pipelined(syndromes, debug_strm)
+                : decode_sequential(syndromes, debug_strm);
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+DECODER_RESULT
+HIER_PYMATCHING::decode_sequential(std::vector<syndrome_type>& syndromes, std::ostream& debug_strm)
+{
+    DECODER_RESULT result;
+
+    for (size_t t = 0; t < tiers.size(); t++)
+    {
+        auto& ts = tiers[t];
+        auto& s = syndromes[t];
+
+        if (GL_DEBUG_DECODER)
+            debug_strm << "tier " << t << " decoder call:\n";
+
+        std::stringstream tier_debug_strm;
+        auto t_start = std::chrono::steady_clock::now();
+        if (ts.sliding != nullptr)
+        {
+            ts.sliding->decode_and_update_inplace(s, result.flipped_observables, tier_debug_strm, ts.dopts);
+        }
+        else
+        {
+            std::vector<GRAPH_COMPONENT_ID> tier_dets;
+            for (size_t w = 0; w < s.num_u64_padded(); w++)
+                for (uint64_t word = s.u64[w]; word; word &= word-1)
+                    tier_dets.push_back(64*w + std::countr_zero(word));
+
+            auto tier_result = ts.global->decode(tier_dets, tier_debug_strm);
+            result.flipped_observables ^= tier_result.flipped_observables;
+            s.clear();
+        }
+        auto t_end = std::chrono::steady_clock::now();
+
+        const uint64_t t_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count();
+        stats[t].busy_ns += t_ns;
+        stats[t].tail_ns += t_ns;
+
+        concat_debug_strm(debug_strm, tier_debug_strm, 1);
+
+        if (t+1 < tiers.size())
+            stats[t].escalated += escalate(t, s, syndromes[t+1], debug_strm);
+    }
+
+    return result;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+DECODER_RESULT
+HIER_PYMATCHING::decode_pipelined(std::vector<syndrome_type>& syndromes, std::ostream& debug_strm)
+{
+    using clock_type = std::chrono::steady_clock;
+
+    const size_t num_tiers = tiers.size();
+
+    // rounds handed to each tier by the previous tier. `syndromes[t]` is only written by tier `t-1` (escalations),
+    // and each round is copied out once it is final:
+    struct channel
+    {
+        std::mutex                mtx;
+        std::condition_variable   cv;
+        std::deque<syndrome_type> rounds;
+    };
+    std::vector<channel> channels(num_tiers);
+
+    std::vector<DECODER_RESULT>    tier_results(num_tiers);
+    std::vector<std::stringstream> tier_debug_strm(num_tiers),
+                                   escalate_debug_strm(num_tiers);
+    std::vector<clock_type::time_point> t_finish(num_tiers);
+
+    const auto t_start = clock_type::now();
+
+    auto _run_tier = [&] (size_t t)
+    {
+        auto& ts = tiers[t];
+        auto& s = syndromes[t];
+        const size_t dpr = ts.detectors_per_round;
+        const auto& dopts = ts.dopts;
+
+        // escalates the leftover defects, and hands off every round of the next tier that is now final:
+        size_t next_round{0};
+        auto _hand_off = [&] (const std::vector<GRAPH_COMPONENT_ID>& leftovers, size_t committed_rounds)
+        {
+            if (t+1 == num_tiers)
+                return;
+
+            auto& next = tiers[t+1];
+            for (auto i : leftovers)
+            {
+                if (static_cast<size_t>(i) >= ts.next_tier_idx.size() || ts.next_tier_idx[i] == NO_IDX)
+                    continue;
+                syndromes[t+1][ts.next_tier_idx[i]] ^= 1;
+                stats[t].escalated++;
+                if (GL_DEBUG_DECODER)
+                    escalate_debug_strm[t] << "\tmoving bit " << i << "(" << ts.next_tier_idx[i] << ") from tier " << t << " to tier " << t+1 << "\n";
+            }
+
+            if (next_round == next.num_rounds || next.ready_at[next_round] > committed_rounds)
+                return;
+
+            auto& ch = channels[t+1];
+            {
+                std::lock_guard<std::mutex> lk(ch.mtx);
+                for (; next_round < next.num_rounds && next.ready_at[next_round] <= committed_rounds; next_round++)
+                {
+                    auto& round = ch.rounds.emplace_back(next.detectors_per_round);
+                    for (size_t i = 0; i < next.detectors_per_round; i++)
+                        round[i] = syndromes[t+1][next_round*next.detectors_per_round + i];
+                }
+            }
+            ch.cv.notify_one();
+        };
+
+        // returns the next round of this tier (rounds of the first tier are final from the start). The tier is
+        // busy whenever it is not waiting here:
+        const auto t_begin = clock_type::now();
+        uint64_t wait_ns{0};
+
+        syndrome_type round(dpr);
+        auto _next_round = [&] (size_t r)
+        {
+            if (t > 0)
+            {
+                auto& ch = channels[t];
+                auto t_wait = clock_type::now();
+                {
+                    std::unique_lock<std::mutex> lk(ch.mtx);
+                    ch.cv.wait(lk, [&ch] { return !ch.rounds.empty(); });
+                    round = std::move(ch.rounds.front());
+                    ch.rounds.pop_front();
+                }
+                wait_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - t_wait).count();
+                return;
+            }
+
+            // most rounds are empty, so the round is only copied bit by bit if its words are not zero:
+            round.clear();
+            bool any{false};
+            for (size_t w = (r*dpr)/64; w <= ((r+1)*dpr-1)/64; w++)
+                any |= (s.u64[w] != 0);
+            if (any)
+            {
+                for (size_t i = 0; i < dpr; i++)
+                    round[i] = s[r*dpr + i];
+            }
+        };
+
+        if (ts.sliding != nullptr)
+        {
+            size_t committed_rounds{0};
+            for (size_t r = 0; r < ts.num_rounds; r++)
+            {
+                _next_round(r);
+                ts.sliding->push_round(round, tier_debug_strm[t], dopts);
+
+                if (ts.sliding->stream_committed_rounds() != committed_rounds)
+                {
+                    committed_rounds = ts.sliding->stream_committed_rounds();
+                    _hand_off(ts.sliding->take_stream_leftovers(), committed_rounds);
+                }
+            }
+
+            tier_results[t] = ts.sliding->finish(tier_debug_strm[t], dopts);
+
+            _hand_off(ts.sliding->take_stream_leftovers(), ts.num_rounds);
+        }
+        else
+        {
+            // a global tier needs all of its rounds:
+            std::vector<GRAPH_COMPONENT_ID> tier_dets;
+            for (size_t r = 0; r < ts.num_rounds; r++)
+            {
+                _next_round(r);
+                for (size_t i = 0; i < dpr; i++)
+                    if (round[i])
+                        tier_dets.push_back(r*dpr + i);
+            }
+
+            tier_results[t] = ts.global->decode(tier_dets, tier_debug_strm[t]);
+
+            _hand_off({}, ts.num_rounds);
+        }
+
+        t_finish[t] = clock_type::now();
+        const uint64_t total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t_finish[t] - t_begin).count();
+        stats[t].busy_ns += (total_ns > wait_ns) ? total_ns - wait_ns : 0;
+    };
+
+    // a tier only waits on the tiers before it, which are claimed first, so this is correct with any number of
+    // threads:
+    thread_pool->parallel_for(num_tiers, [&] (size_t t, size_t) { _run_tier(t); });
+
+    DECODER_RESULT result;
+    for (size_t t = 0; t < num_tiers; t++)
+    {
+        result.flipped_observables ^= tier_results[t].flipped_observables;
+
+        const auto t_prev = (t == 0) ? t_start : std::max(t_start, t_finish[t-1]);
+        if (t_finish[t] > t_prev)
+            stats[t].tail_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t_finish[t] - t_prev).count();
+
+        if (GL_DEBUG_DECODER)
+        {
+            debug_strm << "tier " << t << " decoder call:\n";
+            concat_debug_strm(debug_strm, tier_debug_strm[t], 1);
+            concat_debug_strm(debug_strm, escalate_debug_strm[t], 0);
+        }
+    }
+    return result;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+uint64_t
+HIER_PYMATCHING::escalate(size_t t, syndrome_ref syndrome, syndrome_ref next, std::ostream& debug_strm) const
+{
+    const auto& next_tier_idx = tiers[t].next_tier_idx;
+
+    uint64_t count{0};
+    for (size_t w = 0; w < syndrome.num_u64_padded(); w++)
+    {
+        for (uint64_t word = syndrome.u64[w]; word; word &= word-1)
+        {
+            const size_t i = 64*w + std::countr_zero(word);
+            if (i >= next_tier_idx.size() || next_tier_idx[i] == NO_IDX)
+                continue;
+
+            next[next_tier_idx[i]] ^= 1;
+            count++;
+
+            if (GL_DEBUG_DECODER)
+                debug_strm << "\tmoving bit " << i << "(" << next_tier_idx[i] << ") from tier " << t << " to tier " << t+1 << "\n";
+        }
+    }
+    return count;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+concat_debug_strm(std::ostream& target, std::stringstream& source, size_t tab_count)
+{
+    std::string line;
+    while (std::getline(source, line))
+        target << std::string(tab_count, '\t') << line << "\n";
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
@@ -0,0 +1,167 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#ifndef DECODER_HIER_PYM_h
+#define DECODER_HIER_PYM_h
+
+#include "decoder/sliding_pym.h"
+#include "decoder/surface_code.h"
+#include "thread_pool.h"
+
+#include <limits>
+#include <memory>
+#include <set>
+#include <sstream>
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Hierarchical decoder for circuits that span hardware substrates with different latencies. The
+ * substrates are decoded by an ordered list of tiers, from the fastest to the slowest.
+ *
+ * Detector coordinates are expected to be:
+ *      (..., overall round, base, r_0, r_1, ...)
+ * `base` identifies the check, and the round coordinates (from `FIRST_ROUND_IDX` on) index the rounds
+ * of progressively faster substrates. A tier with `round_depth = L` numbers its rounds with the first L
+ * round coordinates: r_0*n_1*...*n_{L-1} + ... + r_{L-1}, where n_j = `sub_rounds_per_round[j-1]`.
+ * Each tier's circuit provides the error model for its own checks, and its first round of detectors
+ * (overall round 0) gives the detector of each of its checks.
+ *
+ * Every detector starts in its home tier: the fastest tier that has its check. Each tier's checks must
+ * also be checks of the next tier. After a tier is decoded, its remaining defects are escalated to the
+ * next tier, along with the next tier's own defects. With `escalate_boundary_matches`, a tier leaves
+ * every match to the boundary uncommitted, so those defects are escalated as well. With
+ * `escalate_boundary_bases`, only the boundary matches of those checks are left uncommitted.
+ *
+ * Tiers with a `commit_size` are sliding window decoders (the tier circuit is the window circuit, see
+ * `SLIDING_PYMATCHING`), and the others match all of their rounds at once with `PYMATCHING`. A
+ * `PYMATCHING` tier commits every match, so it cannot escalate boundary matches. Neither can the last
+ * tier, as there is no tier to take the escalated defects.
+ *
+ * If `pipelined` is set, each tier runs on its own thread, and the sliding tiers stream their rounds.
+ * A tier hands a round to the next tier as soon as every one of its own rounds that escalates into that
+ * round has been committed. `PYMATCHING` tiers wait for all of their rounds.
+ * */
+
+class HIER_PYMATCHING
+{
+public:
+    constexpr static size_t BASE_DETECTOR_IDX{2};
+    constexpr static size_t FIRST_ROUND_IDX{3};
+
+    struct tier
+    {
+        const stim::Circuit* circuit;
+        size_t               round_depth;
+
+        // window policy: `commit_size = 0` matches all rounds at once:
+        size_t commit_size{0};
+        size_t window_size{0};
+
+        // escalation rule: every match to the boundary, or only those of the checks in `escalate_boundary_bases`:
+        bool             escalate_boundary_matches{false};
+        std::set<size_t> escalate_boundary_bases{};
+    };
+
+    struct options
+    {
+        bool pipelined{false};
+    };
+
+    // accumulated over all decodes:
+    struct tier_stats
+    {
+        uint64_t busy_ns{0};    // time spent in the tier's decoder
+        uint64_t tail_ns{0};    // time from the previous tier finishing (or the start) to this tier finishing
+        uint64_t escalated{0};  // defects escalated to the next tier
+    };
+
+    constexpr static uint32_t NO_IDX{std::numeric_limits<uint32_t>::max()};
+private:
+    struct tier_state
+    {
+        tier   cfg;
+        size_t detectors_per_round{0};
+        size_t num_rounds{0};
+
+        // index in the next tier of each of this tier's detectors (`NO_IDX` if no detector maps to it):
+        std::vector<uint32_t> next_tier_idx;
+
+        // number of rounds of the previous tier that must be committed before each round is final:
+        std::vector<size_t> ready_at;
+
+        // commit policy of the sliding decoder (built once, with a mask of the escalated detectors):
+        SLIDING_PYMATCHING::decode_options dopts;
+
+        std::unique_ptr<SLIDING_PYMATCHING> sliding;
+        std::unique_ptr<PYMATCHING>         global;
+    };
+
+    std::vector<tier_state> tiers;
+    std::vector<size_t>     sub_rounds_per_round;
+
+    // home tier, and index in the home tier, of each detector of the global circuit:
+    std::vector<uint8_t>  home_tier;
+    std::vector<uint32_t> home_idx;
+
+    std::unique_ptr<THREAD_POOL> thread_pool;
+
+    std::vector<tier_stats> stats;
+
+    const options opts;
+public:
+    HIER_PYMATCHING(const stim::Circuit& global, std::vector<tier>, std::vector<size_t> sub_rounds_per_round);
+    HIER_PYMATCHING(const stim::Circuit& global,
+                    std::vector<tier>,
+                    std::vector<size_t> sub_rounds_per_round,
+                    options);
+
+    DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm);
+
+    size_t get_num_tiers() const { return tiers.size(); }
+    size_t get_detectors_per_round(size_t t) const { return tiers[t].detectors_per_round; }
+    size_t get_num_rounds(size_t t) const { return tiers[t].num_rounds; }
+
+    const std::vector<tier_stats>& get_tier_stats() const { return stats; }
+private:
+    DECODER_RESULT decode_sequential(std::vector<syndrome_type>&, std::ostream& debug_strm);
+    DECODER_RESULT decode_pipelined(std::vector<syndrome_type>&, std::ostream& debug_strm);
+
+    // returns the number of defects escalated from `syndrome` (of tier `t`) to `next`:
+    uint64_t escalate(size_t t, syndrome_ref syndrome, syndrome_ref next, std::ostream& debug_strm) const;
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void concat_debug_strm(std::ostream& target, std::stringstream& source, size_t tab_count);
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+// calls `cb(detector id, base)` for each detector in the first round (overall round 0) of `circ`:
+template <class UPDATE_CALLBACK> void
+read_first_round_of_detectors(const stim::Circuit& circ, const UPDATE_CALLBACK& cb)
+{
+    std::set<uint64_t> all_detectors;
+    for (size_t i = 0; i < circ.count_detectors(); i++)
+        all_detectors.insert(all_detectors.end(), i);
+
+    for (const auto& [i, coords] : circ.get_detector_coordinates(all_detectors))
+    {
+        size_t overall_round = static_cast<size_t>(coords[1]),
+               base = static_cast<size_t>(coords[HIER_PYMATCHING::BASE_DETECTOR_IDX]);
+        if (overall_round > 0)
+            continue;
+
+        cb(i, base);
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#endif  // DECODER_HIER_PYM_h
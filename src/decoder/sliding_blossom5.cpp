@@ -0,0 +1,386 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#include "decoder/sliding_blossom5.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <PerfectMatching.h>
+
+extern bool GL_DEBUG_DECODER;
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+SLIDING_BLOSSOM5::SLIDING_BLOSSOM5(
+        const stim::Circuit& circuit,
+        size_t _commit_size,
+        size_t _window_size,
+        size_t _detectors_per_round,
+        size_t _total_rounds)
+    :SLIDING_BLOSSOM5(circuit, _commit_size, _window_size, _detectors_per_round, _total_rounds, options{})
+{
+}
+
+SLIDING_BLOSSOM5::SLIDING_BLOSSOM5(
+        const stim::Circuit& circuit,
+        size_t _commit_size,
+        size_t _window_size,
+        size_t _detectors_per_round,
+        size_t _total_rounds,
+        options _opts)
+    :commit_size(_commit_size),
+    window_size(_window_size),
+    detectors_per_round(_detectors_per_round),
+    total_rounds(_total_rounds),
+    window_decoder(circuit, _opts.window_options),
+    opts(_opts)
+{
+    if (!window_decoder.has_parity_labels())
+        throw std::runtime_error("SLIDING_BLOSSOM5: circuits with more than 64 observables are not supported");
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+DECODER_RESULT
+SLIDING_BLOSSOM5::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm)
+{
+    DECODER_RESULT result;
+
+    syndrome_type syndrome(detectors_per_round * (total_rounds+1));
+    syndrome.clear();
+
+    for (auto d : dets)
+        syndrome[d] = 1;
+
+    decode_and_update_inplace(syndrome, result.flipped_observables, debug_strm, decode_options{});
+    return result;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_BLOSSOM5::decode_and_update_inplace(syndrome_ref syndrome,
+                                            syndrome_ref obs,
+                                            std::ostream& debug_strm,
+                                            const decode_options& dopts)
+{
+    carried.clear();
+
+    // count the defects in each round once (kept up to date as windows are committed), so windows stay
+    // aligned to `commit_size` but skip straight to the next round with a defect:
+    auto defects_by_round = count_defects_by_round(syndrome, detectors_per_round);
+    auto _next_window = [&] (size_t r)
+    {
+        const size_t next_round = next_round_with_defects(defects_by_round, r);
+        if (next_round == defects_by_round.size())
+            return total_rounds+1;
+        return std::max(r, (next_round/commit_size) * commit_size);
+    };
+
+    for (size_t r = _next_window(0); r < total_rounds+1; r = _next_window(r+commit_size))
+    {
+        if (GL_DEBUG_DECODER)
+            debug_strm << "round " << r << ":\n";
+
+        const GRAPH_COMPONENT_ID min_detector = r*detectors_per_round,
+                                 max_detector = (r+window_size)*detectors_per_round,
+                                 max_commit_detector = (r+commit_size)*detectors_per_round;
+
+        window_bounds_type bounds{min_detector, max_detector, max_commit_detector};
+        decode_window(syndrome, obs, bounds, defects_by_round, debug_strm, dopts);
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_BLOSSOM5::decode_window(syndrome_ref syndrome,
+                                syndrome_ref obs,
+                                window_bounds_type bounds,
+                                std::vector<uint32_t>& defects_by_round,
+                                std::ostream& debug_strm,
+                                const decode_options& dopts)
+{
+    auto [d_min, d_max, d_commit_max] = bounds;
+    const size_t offset = (d_min == 0) ? 0 : detectors_per_round;
+
+    std::vector<GRAPH_COMPONENT_ID> window_dets, true_ids;
+    for_each_defect(syndrome, d_min, d_max,
+            [&] (size_t i)
+            {
+                window_dets.push_back(i-d_min+offset);
+                true_ids.push_back(i);
+            });
+
+    // nothing is committed, so there is no matching to carry into the next window either:
+    if (true_ids.empty() || true_ids.front() >= d_commit_max)
+    {
+        carried.clear();
+        return;
+    }
+
+    if (GL_DEBUG_DECODER)
+    {
+        debug_strm << "\t(min = " << d_min << ", max = " << d_max << ", commit_max = " << d_commit_max
+            << ") detectors in window:";
+        for (auto d : true_ids)
+            debug_strm << " " << d;
+        debug_strm << "\n";
+    }
+
+    const auto prob = window_decoder.compute_distances(std::move(window_dets));
+    const size_t n = prob.size();
+
+    const bool use_warm_start = opts.warm_start && n >= opts.warm_start_min_defects;
+    std::vector<size_t> mate = use_warm_start ? solve_warm(prob, true_ids, debug_strm) : solve_cold(prob);
+
+    // commit matches: a pair is committed if either defect is in the commit region. Pairs whose shortest
+    // path goes through the boundary are treated as two boundary matches.
+    std::vector<bool> committed(n, false);
+
+    // every committed defect is cleared from the syndrome:
+    auto _clear = [&] (size_t i)
+    {
+        syndrome[true_ids[i]] = 0;
+        defects_by_round[true_ids[i] / detectors_per_round]--;
+        committed[i] = true;
+    };
+
+    auto _commit = [&] (size_t i, size_t j)
+    {
+        obs.u64[0] ^= window_decoder.path_parity(prob, i, j);
+        _clear(i);
+        if (j < n)
+            _clear(j);
+
+        if (GL_DEBUG_DECODER)
+        {
+            debug_strm << "\tcommitted match between " << true_ids[i] << " and "
+                << (j < n ? static_cast<int64_t>(true_ids[j]) : -1) << ", weight = " << prob.dist(i, j) << "\n";
+        }
+    };
+
+    auto _commit_boundary = [&] (size_t i)
+    {
+        if (true_ids[i] >= d_commit_max)
+            return;
+        if (!dopts.commits_boundary(true_ids[i]))
+            return;
+        _commit(i, n);
+    };
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const size_t j = mate[i];
+        if (j < i)
+            continue;
+
+        if (j == n || prob.through_boundary(i, j))
+        {
+            _commit_boundary(i);
+            if (j < n)
+                _commit_boundary(j);
+        }
+        else if (true_ids[i] < d_commit_max || true_ids[j] < d_commit_max)
+        {
+            _commit(i, j);
+        }
+    }
+
+    // carry the pairs that were matched entirely outside the commit region into the next window:
+    carried.clear();
+    if (!opts.warm_start)
+        return;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const size_t j = mate[i];
+        if (j == n || committed[i] || committed[j] || true_ids[i] < d_commit_max || true_ids[j] < d_commit_max)
+            continue;
+        if (!prob.through_boundary(i, j))
+            carried.push_back({true_ids[i], true_ids[j]});
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+std::vector<size_t>
+SLIDING_BLOSSOM5::solve_cold(const BLOSSOM5::matching_problem& prob) const
+{
+    const size_t n = prob.size();
+    const bool has_boundary_node = n & 1;
+
+    b5::PerfectMatching pm(n + has_boundary_node, ((n*(n-1)) >> 1) + (has_boundary_node ? n : 0));
+    pm.options.verbose = false;
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = i+1; j < n; j++)
+            pm.AddEdge(i, j, prob.pair_dist[i*n+j]);
+
+    if (has_boundary_node)
+    {
+        for (size_t i = 0; i < n; i++)
+            pm.AddEdge(i, n, prob.boundary_dist[i]);
+    }
+
+    pm.Solve();
+
+    std::vector<size_t> mate(n);
+    for (size_t i = 0; i < n; i++)
+        mate[i] = pm.GetMatch(i);
+    return mate;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+std::vector<size_t>
+SLIDING_BLOSSOM5::solve_warm(const BLOSSOM5::matching_problem& prob,
+                                const std::vector<GRAPH_COMPONENT_ID>& true_ids,
+                                std::ostream& debug_strm) const
+{
+    const size_t n = prob.size();
+    const bool has_boundary_node = n & 1;
+    const size_t max_edges = ((n*(n-1)) >> 1) + (has_boundary_node ? n : 0);
+
+    // look up the carried pairs (both `carried` and `true_ids` are sorted):
+    std::vector<int64_t> seed_mate(n, -1);
+    for (size_t i = 0, c = 0; i < n; i++)
+    {
+        while (c < carried.size() && carried[c].id < true_ids[i])
+            c++;
+        if (c == carried.size() || carried[c].id != true_ids[i])
+            continue;
+
+        auto it = std::lower_bound(true_ids.begin(), true_ids.end(), carried[c].mate);
+        if (it != true_ids.end() && *it == carried[c].mate)
+            seed_mate[i] = it - true_ids.begin();
+    }
+
+    b5::PerfectMatching pm(n + has_boundary_node, max_edges);
+    pm.options.verbose = false;
+
+    std::vector<bool> has_edge(n*n, false);
+    size_t num_seed_edges{0};
+    auto _add = [&] (size_t i, size_t j)
+    {
+        if (i > j)
+            std::swap(i, j);
+        if (has_edge[i*n+j])
+            return;
+        has_edge[i*n+j] = true;
+        pm.AddEdge(i, j, prob.pair_dist[i*n+j]);
+        num_seed_edges++;
+    };
+
+    // (1) the previous window's matching:
+    for (size_t i = 0; i < n; i++)
+        if (seed_mate[i] > static_cast<int64_t>(i))
+            _add(i, seed_mate[i]);
+
+    // (2) each defect's nearest neighbors, and (3) every pair that would be tight if each defect's dual
+    // were twice the distance to its nearest neighbor (or the boundary):
+    std::vector<int64_t> hint(n);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        hint[i] = 2*static_cast<int64_t>(prob.boundary_dist[i]);
+        if (n == 1)
+            continue;
+
+        std::iota(order.begin(), order.end(), 0);
+        std::swap(order[i], order.back());
+        const size_t k = std::max<size_t>(1, std::min(opts.seed_knn, n-1));
+        std::partial_sort(order.begin(), order.begin()+k, order.end()-1,
+                            [&prob, i, n] (size_t x, size_t y) { return prob.pair_dist[i*n+x] < prob.pair_dist[i*n+y]; });
+        for (size_t x = 0; x < k; x++)
+            _add(i, order[x]);
+        hint[i] = std::min<int64_t>(hint[i], 2*static_cast<int64_t>(prob.pair_dist[i*n+order[0]]));
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = i+1; j < n; j++)
+            if (2*static_cast<int64_t>(prob.pair_dist[i*n+j]) <= hint[i] + hint[j])
+                _add(i, j);
+
+    // pair up the defects without a seed match, so the initial graph has a perfect matching:
+    size_t last_unpaired = n;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (seed_mate[i] >= 0)
+            continue;
+        if (last_unpaired == n)
+        {
+            last_unpaired = i;
+        }
+        else
+        {
+            _add(last_unpaired, i);
+            last_unpaired = n;
+        }
+    }
+
+    // the boundary node (if any) is connected to every defect, and is never priced:
+    if (has_boundary_node)
+    {
+        for (size_t i = 0; i < n; i++)
+            pm.AddEdge(i, n, prob.boundary_dist[i]);
+    }
+
+    pm.Solve();
+
+    // price the remaining pairs: `(i,j)` can only improve the matching if `2*d(i,j) < y_i + y_j`:
+    std::vector<int64_t> twice_dual(n);
+    size_t num_rounds{0},
+           num_priced_edges{0};
+    while (true)
+    {
+        pm.StartUpdate();
+        for (size_t i = 0; i < n; i++)
+            twice_dual[i] = pm.GetTwiceSum(i);
+
+        size_t added{0};
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = i+1; j < n; j++)
+            {
+                if (has_edge[i*n+j] || 2*static_cast<int64_t>(prob.pair_dist[i*n+j]) >= twice_dual[i] + twice_dual[j])
+                    continue;
+                if (pm.AddNewEdge(i, j, prob.pair_dist[i*n+j], true) >= 0)
+                {
+                    has_edge[i*n+j] = true;
+                    added++;
+                }
+            }
+        }
+        pm.FinishUpdate();
+        pm.Solve();
+
+        num_rounds++;
+        num_priced_edges += added;
+        if (added == 0)
+            break;
+    }
+
+    if (GL_DEBUG_DECODER)
+    {
+        debug_strm << "\twarm start: " << num_seed_edges << " seed edges, " << num_priced_edges
+            << " priced edges (of " << ((n*(n-1)) >> 1) << "), " << num_rounds << " pricing rounds\n";
+    }
+
+    std::vector<size_t> mate(n);
+    for (size_t i = 0; i < n; i++)
+        mate[i] = pm.GetMatch(i);
+    return mate;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#ifndef DECODER_SLIDING_BLOSSOM5_h
+#define DECODER_SLIDING_BLOSSOM5_h
+
+#include "decoder/common.h"
+#include "decoder/surface_code.h"
+#include "decoder/sliding_pym.h"
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Sliding window decoder that matches each window with Blossom V. The window circuit follows the
+ * same convention as `SLIDING_PYMATCHING` (it should have `window_size+1` rounds).
+ *
+ * Consecutive windows overlap by `window_size - commit_size` rounds, and the defects in the overlap
+ * are carried into the next window. If `warm_start` is set, the next window does not start from the
+ * complete defect graph. Instead, it starts from:
+ *  (1) the previous window's matched pairs whose defects were both carried over,
+ *  (2) each defect's `seed_knn` nearest defects,
+ *  (3) every pair that would be tight if each defect's dual was its nearest-neighbor distance,
+ * and a pairing of the remaining defects (so the seed graph has a perfect matching). Blossom V solves this
+ * sparse graph, and then the remaining pairs are priced against its dual solution (`StartUpdate`/`AddNewEdge`/
+ * `FinishUpdate`) until no pair has negative slack. The final matching is therefore optimal for the
+ * complete graph, as in a cold solve.
+ * */
+
+class SLIDING_BLOSSOM5
+{
+public:
+    using decode_options = SLIDING_PYMATCHING::decode_options;
+    using window_bounds_type = SLIDING_PYMATCHING::window_bounds_type;
+
+    struct options
+    {
+        BLOSSOM5::options window_options{};
+
+        bool   warm_start{true};
+        size_t seed_knn{2};
+
+        // pricing has a fixed cost per round, so windows with fewer defects are always solved cold:
+        size_t warm_start_min_defects{32};
+    };
+
+    const size_t commit_size;
+    const size_t window_size;
+    const size_t detectors_per_round;
+    const size_t total_rounds;
+private:
+    // a defect carried into the next window, and the (also carried) defect it was matched to:
+    struct carried_defect
+    {
+        GRAPH_COMPONENT_ID id;
+        GRAPH_COMPONENT_ID mate;
+    };
+
+    BLOSSOM5 window_decoder;
+
+    // sorted by `id`. Only valid within one call to `decode_and_update_inplace`:
+    std::vector<carried_defect> carried;
+
+    const options opts;
+public:
+    SLIDING_BLOSSOM5(const stim::Circuit&,
+                        size_t commit_size,
+                        size_t window_size,
+                        size_t detectors_per_round,
+                        size_t total_rounds);
+    SLIDING_BLOSSOM5(const stim::Circuit&,
+                        size_t commit_size,
+                        size_t window_size,
+                        size_t detectors_per_round,
+                        size_t total_rounds,
+                        options);
+
+    DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm);
+
+    void decode_and_update_inplace(syndrome_ref, syndrome_ref, std::ostream& debug_strm, const decode_options&);
+private:
+    // `defects_by_round` is updated with the committed corrections:
+    void decode_window(syndrome_ref, 
+                        syndrome_ref, 
+                        window_bounds_type, 
+                        std::vector<uint32_t>& defects_by_round, 
+                        std::ostream&, 
+                        const decode_options&);
+
+    // returns the mate of each defect (`prob.size()` for the boundary). `true_ids` are the global
+    // detector ids of `prob.dets` (used to look up carried state).
+    std::vector<size_t> solve_cold(const BLOSSOM5::matching_problem&) const;
+    std::vector<size_t> solve_warm(const BLOSSOM5::matching_problem&,
+                                    const std::vector<GRAPH_COMPONENT_ID>& true_ids,
+                                    std::ostream& debug_strm) const;
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#endif  // DECODER_SLIDING_BLOSSOM5_h
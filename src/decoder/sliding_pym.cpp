@@ -6,6 +6,10 @@
 #include "decoder/sliding_pym.h"
 #include "decoder/surface_code.h"
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <sstream>
 #include <utility>
 
 extern bool GL_DEBUG_DECODER;
@@ -19,12 +23,60 @@ SLIDING_PYMATCHING::SLIDING_PYMATCHING(
         size_t _window_size,
         size_t _detectors_per_round,
         size_t _total_rounds)
+    :SLIDING_PYMATCHING(circuit, _commit_size, _window_size, _detectors_per_round, _total_rounds, options{})
+{
+}
+
+SLIDING_PYMATCHING::SLIDING_PYMATCHING(
+        const stim::Circuit& circuit, 
+        size_t _commit_size, 
+        size_t _window_size,
+        size_t _detectors_per_round,
+        size_t _total_rounds,
+        options _opts)
     :commit_size(_commit_size),
     window_size(_window_size),
     detectors_per_round(_detectors_per_round),
     total_rounds(_total_rounds),
-    mwpm{pymatching_create_mwpm_from_circuit(circuit, true)}
+    mwpm{pymatching_create_mwpm_from_circuit(circuit, true)},
+    stream_syndrome(std::max((_window_size+1)*_detectors_per_round, mwpm.flooder.graph.nodes.size())),
+    opts(_opts)
 {
+    // `decode_detection_events_to_match_edges` does not support negative weights:
+    if (mwpm.flooder.negative_weight_sum != 0)
+        throw std::runtime_error("SLIDING_PYMATCHING: error models with negative edge weights are not supported");
+
+    if (mwpm.flooder.graph.num_observables <= 8*sizeof(pm::obs_int))
+    {
+        const auto& nodes = mwpm.search_flooder.graph.nodes;
+        edge_obs_offset.reserve(nodes.size()+1);
+        for (const auto& n : nodes)
+        {
+            edge_obs_offset.push_back(edge_obs_mask.size());
+            for (const auto& obs_indices : n.neighbor_observable_indices)
+            {
+                pm::obs_int mask{0};
+                for (size_t o : obs_indices)
+                    mask ^= pm::obs_int{1} << o;
+                edge_obs_mask.push_back(mask);
+            }
+        }
+        edge_obs_offset.push_back(edge_obs_mask.size());
+    }
+
+    if (opts.parallel_windows && opts.pipelined_windows)
+        throw std::runtime_error("SLIDING_PYMATCHING: parallel and pipelined windows cannot be combined");
+    if (!opts.parallel_windows && !opts.pipelined_windows)
+        return;
+
+    if (opts.parallel_windows && window_size < commit_size+2)
+        throw std::runtime_error("SLIDING_PYMATCHING: parallel windows need a buffer of at least one round on each side");
+
+    const size_t num_threads = opts.pipelined_windows ? 2 : std::max<size_t>(1, opts.num_threads);
+    worker_mwpm.reserve(num_threads-1);
+    for (size_t t = 1; t < num_threads; t++)
+        worker_mwpm.emplace_back(pymatching_create_mwpm_from_circuit(circuit, true));
+    thread_pool = std::make_unique<THREAD_POOL>(num_threads);
 }
 
 /////////////////////////////////////////////////////
@@ -53,23 +105,144 @@ void
 SLIDING_PYMATCHING::decode_and_update_inplace(syndrome_ref syndrome, 
                                                 syndrome_ref obs, 
                                                 std::ostream& debug_strm, 
-                                                decode_options opts)
+                                                const decode_options& dopts)
 {
-    size_t r{0};
-    while (r < total_rounds+1 && syndrome.popcnt() > 0)
+    if (opts.parallel_windows)
+    {
+        decode_parallel(syndrome, obs, debug_strm, dopts);
+        return;
+    }
+
+    // count the defects in each round once, and keep the counts up to date as windows are committed:
+    auto defects_by_round = count_defects_by_round(syndrome, detectors_per_round);
+
+    if (opts.pipelined_windows)
+    {
+        decode_pipelined(syndrome, obs, defects_by_round, debug_strm, dopts);
+        return;
+    }
+
+    for (auto p = plan_window(0, defects_by_round); p.window_rounds > 0; p = plan_window(p.r+p.commit_rounds, defects_by_round))
     {
         if (GL_DEBUG_DECODER)
-            debug_strm << "round " << r << ":\n";
+            debug_strm << "round " << p.r << ":\n";
+
+        decode_window(syndrome, obs, plan_bounds(p), defects_by_round, debug_strm, dopts);
+        record_plan(p);
+    }
+}
 
-        const GRAPH_COMPONENT_ID min_detector = r*detectors_per_round,
-                                 max_detector = (r+window_size)*detectors_per_round,
-                                 max_commit_detector = (r+commit_size)*detectors_per_round;
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
 
-        window_bounds_type bounds{min_detector, max_detector, max_commit_detector};
-        decode_window(syndrome, obs, bounds, debug_strm, opts);
+void
+SLIDING_PYMATCHING::push_round(syndrome_ref round_detectors, std::ostream& debug_strm)
+{
+    push_round(round_detectors, debug_strm, decode_options{});
+}
 
-        r += commit_size;
+void
+SLIDING_PYMATCHING::push_round(syndrome_ref round_detectors, std::ostream& debug_strm, const decode_options& dopts)
+{
+    // the buffer past `stream_rounds` is clear, so empty rounds need no copy:
+    const size_t base = stream_rounds*detectors_per_round;
+    if (round_detectors.not_zero())
+    {
+        for (size_t i = 0; i < detectors_per_round; i++)
+            stream_syndrome[base+i] = round_detectors[i];
     }
+    stream_rounds++;
+
+    if (stream_rounds - stream_has_lead == window_size)
+        stream_commit(debug_strm, dopts);
+}
+
+DECODER_RESULT
+SLIDING_PYMATCHING::finish(std::ostream& debug_strm)
+{
+    return finish(debug_strm, decode_options{});
+}
+
+DECODER_RESULT
+SLIDING_PYMATCHING::finish(std::ostream& debug_strm, const decode_options& dopts)
+{
+    // the last windows are shorter than `window_size`:
+    while (stream_rounds > stream_has_lead && stream_syndrome.not_zero())
+        stream_commit(debug_strm, dopts);
+
+    // whatever is left was not committed:
+    for_each_defect(stream_syndrome, 0, stream_syndrome.num_bits_padded(),
+            [this] (size_t i) { stream_leftovers.push_back(stream_first_round*detectors_per_round + i); });
+
+    DECODER_RESULT result;
+    result.flipped_observables = stream_obs;
+
+    stream_syndrome.clear();
+    stream_obs.clear();
+    stream_first_round = 0;
+    stream_rounds = 0;
+    stream_has_lead = false;
+    return result;
+}
+
+std::vector<GRAPH_COMPONENT_ID>
+SLIDING_PYMATCHING::take_stream_leftovers()
+{
+    std::vector<GRAPH_COMPONENT_ID> out;
+    out.swap(stream_leftovers);
+    return out;
+}
+
+void
+SLIDING_PYMATCHING::stream_commit(std::ostream& debug_strm, const decode_options& dopts)
+{
+    const auto dpr = static_cast<GRAPH_COMPONENT_ID>(detectors_per_round);
+    const size_t lead = stream_has_lead ? 1 : 0,
+                 num_committed = std::min(commit_size, stream_rounds-lead),
+                 num_dropped = lead + num_committed - 1;
+
+    // nothing to match or drop:
+    if (!stream_syndrome.not_zero())
+    {
+        stream_first_round += num_dropped;
+        stream_rounds -= num_dropped;
+        stream_has_lead = true;
+        return;
+    }
+
+    if (GL_DEBUG_DECODER)
+        debug_strm << "round " << stream_first_round+lead << ":\n";
+
+    // the window is [`lead`, `stream_rounds`). With the lead round in front, the buffer index of each
+    // detector is its index in the window circuit:
+    window_bounds_type bounds{lead*dpr, stream_rounds*dpr, (lead+commit_size)*dpr};
+
+    window_commit commit;
+    match_window(mwpm, stream_syndrome, bounds, 0, lead*detectors_per_round, commit, debug_strm, dopts);
+
+    apply_commit(stream_syndrome, stream_obs, commit, nullptr);
+
+    // drop every round before the last committed round, which becomes the lead round. Any defect left in
+    // the dropped rounds was not committed:
+    const size_t shift = num_dropped*detectors_per_round;
+    for_each_defect(stream_syndrome, 0, shift,
+            [this] (size_t i) { stream_leftovers.push_back(stream_first_round*detectors_per_round + i); });
+
+    // shift the buffer down a word at a time:
+    const size_t num_words = stream_syndrome.num_u64_padded(),
+                 word_shift = shift/64,
+                 bit_shift = shift & 63;
+    auto _word = [&] (size_t w) { return (w < num_words) ? stream_syndrome.u64[w] : uint64_t{0}; };
+    for (size_t w = 0; w < num_words; w++)
+    {
+        const uint64_t lo = _word(w+word_shift),
+                       hi = _word(w+word_shift+1);
+        stream_syndrome.u64[w] = bit_shift ? (lo >> bit_shift) | (hi << (64-bit_shift)) : lo;
+    }
+
+    stream_first_round += num_dropped;
+    stream_rounds -= num_dropped;
+    stream_has_lead = true;
 }
 
 /////////////////////////////////////////////////////
@@ -79,24 +252,308 @@ void
 SLIDING_PYMATCHING::decode_window(syndrome_ref syndrome, 
                                 syndrome_ref obs,
                                 window_bounds_type bounds,
+                                std::vector<uint32_t>& defects_by_round,
                                 std::ostream& debug_strm,
-                                decode_options opts)
+                                const decode_options& dopts)
+{
+    window_commit commit;
+    match_window(mwpm, syndrome, bounds, 0, window_offset(std::get<0>(bounds)), commit, debug_strm, dopts);
+
+    auto t_start = std::chrono::steady_clock::now();
+    apply_commit(syndrome, obs, commit, defects_by_round.data());
+    auto t_end = std::chrono::steady_clock::now();
+
+    stats.windows++;
+    stats.flood_ns += commit.flood_ns;
+    stats.path_ns += commit.path_ns;
+    stats.commit_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count();
+}
+
+void
+SLIDING_PYMATCHING::decode_pipelined(syndrome_ref syndrome,
+                                        syndrome_ref obs,
+                                        std::vector<uint32_t>& defects_by_round,
+                                        std::ostream& debug_strm,
+                                        const decode_options& dopts)
+{
+    window_commit commits[2];
+    std::stringstream window_debug_strm[2];
+
+    auto p = plan_window(0, defects_by_round);
+    while (p.window_rounds > 0)
+    {
+        // speculate: plan the next window from the syndrome before `p` is committed:
+        const auto q = plan_window(p.r+p.commit_rounds, defects_by_round);
+        if (q.window_rounds == 0)
+        {
+            if (GL_DEBUG_DECODER)
+                debug_strm << "round " << p.r << ":\n";
+            decode_window(syndrome, obs, plan_bounds(p), defects_by_round, debug_strm, dopts);
+            record_plan(p);
+            p = plan_window(p.r+p.commit_rounds, defects_by_round);
+            continue;
+        }
+
+        const window_plan plans[2]{p, q};
+        for (size_t i = 0; i < 2; i++)
+        {
+            commits[i] = window_commit{};
+            if (GL_DEBUG_DECODER)
+                window_debug_strm[i].str("");
+        }
+
+        thread_pool->parallel_for(2,
+                [&, this] (size_t i, size_t worker_id)
+                {
+                    auto& m = (worker_id == 0) ? mwpm : worker_mwpm[worker_id-1];
+                    std::ostream& strm = GL_DEBUG_DECODER ? window_debug_strm[i] : debug_strm;
+                    const auto bounds = plan_bounds(plans[i]);
+                    match_window(m, syndrome, bounds, 0, window_offset(std::get<0>(bounds)), commits[i], strm, dopts);
+                });
+
+        // apply `p`. The speculative result is only valid if `p` flipped nothing at or after the end of its
+        // commit region (this covers both `q`'s window and the rounds skipped before it):
+        const GRAPH_COMPONENT_ID d_spec = (p.r+p.commit_rounds)*detectors_per_round;
+        const bool hit = std::none_of(commits[0].flipped_detectors.begin(), commits[0].flipped_detectors.end(),
+                                        [d_spec] (GRAPH_COMPONENT_ID d) { return d >= d_spec; });
+        stats.speculated_windows++;
+        stats.speculation_hits += hit;
+
+        const size_t num_applied = hit ? 2 : 1;
+        for (size_t i = 0; i < num_applied; i++)
+        {
+            auto t_start = std::chrono::steady_clock::now();
+            apply_commit(syndrome, obs, commits[i], defects_by_round.data());
+            auto t_end = std::chrono::steady_clock::now();
+
+            stats.windows++;
+            stats.flood_ns += commits[i].flood_ns;
+            stats.path_ns += commits[i].path_ns;
+            stats.commit_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count();
+            record_plan(plans[i]);
+
+            if (GL_DEBUG_DECODER)
+                debug_strm << "round " << plans[i].r << ":\n" << window_debug_strm[i].rdbuf();
+        }
+
+        // on a miss, `q` is planned again (from the updated syndrome) and decoded in the next step:
+        const auto& last = plans[num_applied-1];
+        p = plan_window(last.r+last.commit_rounds, defects_by_round);
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_PYMATCHING::apply_commit(syndrome_ref syndrome, 
+                                    syndrome_ref obs, 
+                                    const window_commit& commit, 
+                                    uint32_t* defects_by_round) const
+{
+    for (auto d : commit.flipped_detectors)
+    {
+        // detectors past the end of the syndrome are in rounds that the window circuit has, but the
+        // decoded circuit does not:
+        if (d < 0 || static_cast<size_t>(d) >= syndrome.num_bits_padded())
+            continue;
+
+        if (defects_by_round != nullptr)
+        {
+            auto& count = defects_by_round[d / detectors_per_round];
+            count = syndrome[d] ? count-1 : count+1;
+        }
+        syndrome[d] ^= 1;
+    }
+
+    for (pm::obs_int m = commit.obs_mask; m; m &= m-1)
+        obs[std::countr_zero(m)] ^= 1;
+    for (auto o : commit.flipped_observables)
+        obs[o] ^= 1;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+SLIDING_PYMATCHING::window_plan
+SLIDING_PYMATCHING::plan_window(size_t r, const std::vector<uint32_t>& defects_by_round) const
+{
+    const size_t next_round = next_round_with_defects(defects_by_round, r);
+    if (next_round == defects_by_round.size())
+        return window_plan{};
+
+    // adaptive windows start at the defect, fixed windows stay aligned to `commit_size`:
+    r = opts.adaptive_windows ? next_round : std::max(r, (next_round/commit_size) * commit_size);
+    if (r >= total_rounds+1)
+        return window_plan{};
+
+    if (opts.adaptive_windows)
+        return adaptive_window_bounds(r, defects_by_round);
+    return window_plan{.r=r, .window_rounds=window_size, .commit_rounds=commit_size};
+}
+
+SLIDING_PYMATCHING::window_bounds_type
+SLIDING_PYMATCHING::plan_bounds(const window_plan& p) const
+{
+    return window_bounds_type{p.r*detectors_per_round, 
+                                (p.r+p.window_rounds)*detectors_per_round, 
+                                (p.r+p.commit_rounds)*detectors_per_round};
+}
+
+void
+SLIDING_PYMATCHING::record_plan(const window_plan& p)
+{
+    stats.commit_rounds += p.commit_rounds;
+    stats.window_rounds += p.window_rounds;
+    stats.isolated_windows += p.isolated;
+    stats.grown_buffers += p.grown;
+}
+
+SLIDING_PYMATCHING::window_plan
+SLIDING_PYMATCHING::adaptive_window_bounds(size_t r, const std::vector<uint32_t>& defects_by_round) const
+{
+    const size_t max_buffer = window_size - commit_size,
+                 min_buffer = opts.adaptive_min_buffer ? std::min(opts.adaptive_min_buffer, max_buffer) : max_buffer/2,
+                 quiet_rounds = opts.adaptive_quiet_rounds ? opts.adaptive_quiet_rounds : commit_size;
+
+    // rounds past the end of the syndrome have no defects:
+    auto _defects = [&defects_by_round] (size_t x) { return (x < defects_by_round.size()) ? defects_by_round[x] : 0; };
+
+    // (1) look for a quiet run that starts within the window:
+    size_t run{0};
+    for (size_t x = r+1; x < r+window_size+quiet_rounds; x++)
+    {
+        run = _defects(x) ? 0 : run+1;
+        if (run == quiet_rounds)
+        {
+            const size_t g = x+1-quiet_rounds;
+            if (g > r+window_size)
+                break;
+
+            return window_plan{.r=r, .window_rounds=g-r, .commit_rounds=g-r, .isolated=true};
+        }
+    }
+
+    // (2) grow the buffer if there are defects within `min_buffer/2` rounds of the commit boundary:
+    const size_t c = r+commit_size,
+                 h = std::max<size_t>(1, min_buffer/2);
+    for (size_t x = c-std::min(h, commit_size); x < c+h; x++)
+    {
+        if (_defects(x))
+        {
+            return window_plan{.r=r, .window_rounds=commit_size+max_buffer, .commit_rounds=commit_size, .grown=true};
+        }
+    }
+    return window_plan{.r=r, .window_rounds=commit_size+min_buffer, .commit_rounds=commit_size};
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_PYMATCHING::decode_parallel(syndrome_ref syndrome,
+                                    syndrome_ref obs,
+                                    std::ostream& debug_strm,
+                                    const decode_options& dopts)
+{
+    const size_t buffer = (window_size - commit_size) / 2,
+                 period = commit_size + 2*buffer,
+                 num_rounds = total_rounds+1;
+    const auto dpr = static_cast<GRAPH_COMPONENT_ID>(detectors_per_round);
+
+    // layer A: the cores start every `period` rounds, and each window adds a buffer on both sides:
+    std::vector<window_bounds_type> windows;
+    std::vector<GRAPH_COMPONENT_ID> commit_min;
+    for (size_t c = 0; c < num_rounds; c += period)
+    {
+        const size_t r_min = (c > buffer) ? c-buffer : 0;
+        windows.emplace_back(r_min*dpr, (c+commit_size+buffer)*dpr, (c+commit_size)*dpr);
+        commit_min.push_back(c*dpr);
+    }
+
+    if (GL_DEBUG_DECODER)
+        debug_strm << "layer A (" << windows.size() << " windows, buffer = " << buffer << "):\n";
+    decode_layer(syndrome, obs, windows, commit_min, debug_strm, dopts);
+
+    if (syndrome.popcnt() == 0)
+        return;
+
+    // layer B: the gaps between the cores:
+    windows.clear();
+    commit_min.clear();
+    for (size_t g = commit_size; g < num_rounds; g += period)
+    {
+        windows.emplace_back(g*dpr, (g+2*buffer)*dpr, (g+2*buffer)*dpr);
+        commit_min.push_back(g*dpr);
+    }
+
+    if (GL_DEBUG_DECODER)
+        debug_strm << "layer B (" << windows.size() << " windows):\n";
+    decode_layer(syndrome, obs, windows, commit_min, debug_strm, dopts);
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_PYMATCHING::decode_layer(syndrome_ref syndrome,
+                                    syndrome_ref obs,
+                                    const std::vector<window_bounds_type>& windows,
+                                    const std::vector<GRAPH_COMPONENT_ID>& commit_min,
+                                    std::ostream& debug_strm,
+                                    const decode_options& dopts)
+{
+    std::vector<window_commit> commits(windows.size());
+    std::vector<std::stringstream> window_debug_strm(GL_DEBUG_DECODER ? windows.size() : 0);
+
+    thread_pool->parallel_for(windows.size(),
+            [&, this] (size_t i, size_t worker_id)
+            {
+                auto& m = (worker_id == 0) ? mwpm : worker_mwpm[worker_id-1];
+                std::ostream& strm = GL_DEBUG_DECODER ? window_debug_strm[i] : debug_strm;
+                match_window(m, syndrome, windows[i], commit_min[i], window_offset(std::get<0>(windows[i])), 
+                                commits[i], strm, dopts);
+            });
+
+    // the windows only read the syndrome, so the corrections can be applied now:
+    for (size_t i = 0; i < windows.size(); i++)
+    {
+        apply_commit(syndrome, obs, commits[i], nullptr);
+
+        if (GL_DEBUG_DECODER)
+            debug_strm << window_debug_strm[i].rdbuf();
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+SLIDING_PYMATCHING::match_window(pm::Mwpm& m,
+                                    syndrome_ref syndrome, 
+                                    window_bounds_type bounds,
+                                    GRAPH_COMPONENT_ID d_commit_min,
+                                    size_t offset,
+                                    window_commit& commit,
+                                    std::ostream& debug_strm,
+                                    const decode_options& dopts)
 {
     std::vector<uint64_t> window_dets;
 
     auto [d_min, d_max, d_commit_max] = bounds;
-    const size_t offset = (d_min == 0) ? 0 : detectors_per_round;
 
     // use `_true_id` to make the code less verbose
-    auto _true_id = [d_min, offset] (const int64_t node) { return (node <= 0) ? node : node - offset + d_min; };
+    auto _true_id = [d_min, offset] (const int64_t node) { return (node < 0) ? node : node - offset + d_min; };
 
-    for (size_t i = d_min; i < d_max && i < syndrome.num_bits_padded(); i++)
-    {
-        if (syndrome[i])
-            window_dets.push_back(i-d_min+offset);
-    }
+    bool any_in_commit{false};
+    for_each_defect(syndrome, d_min, d_max,
+            [&] (size_t i)
+            {
+                window_dets.push_back(i-d_min+offset);
+                any_in_commit |= (static_cast<GRAPH_COMPONENT_ID>(i) >= d_commit_min && static_cast<GRAPH_COMPONENT_ID>(i) < d_commit_max);
+            });
 
-    if (window_dets.empty() || _true_id(window_dets.front()) >= d_commit_max)
+    if (!any_in_commit)
         return;
 
     if (GL_DEBUG_DECODER)
@@ -108,25 +565,27 @@ SLIDING_PYMATCHING::decode_window(syndrome_ref syndrome,
         debug_strm << "\n";
     }
     
-    // run pymatching and get matched edges
-    mwpm.reset();
-    std::vector<int64_t> edges;
-    pm::decode_detection_events_to_edges(mwpm, window_dets, edges);
+    // match the defects. Flooding and path tracing only clean up the nodes they touched, so the matcher
+    // is never reset between windows:
+    auto t_start = std::chrono::steady_clock::now();
+    pm::decode_detection_events_to_match_edges(m, window_dets);
+    auto t_flood = std::chrono::steady_clock::now();
 
-    for (size_t i = 0; i < edges.size(); i += 2) 
-    {
-        int64_t node1 = edges[i];
-        int64_t node2 = edges[i+1];
+    auto& search = m.search_flooder;
+    const auto* nodes = search.graph.nodes.data();
 
-        if (node1 < 0)
-            std::swap(node1, node2);
+    auto _handle_edge = [&] (const pm::SearchGraphEdge& e)
+    {
+        const auto* neighbor = e.detector_node->neighbors[e.neighbor_index];
 
-        const int64_t true_node1 = (node1 < 0) ? node1 : _true_id(node1),
+        const int64_t node1 = e.detector_node - nodes,
+                      node2 = (neighbor == nullptr) ? -1 : neighbor - nodes;
+        const int64_t true_node1 = _true_id(node1),
                       true_node2 = (node2 < 0) ? node2 : _true_id(node2);
 
         // Only commit observables if at least one detector is in commit region
-        const bool node1_in_commit = (true_node1 >= 0) && (true_node1 < d_commit_max);
-        const bool node2_in_commit = (true_node2 >= 0) && (true_node2 < d_commit_max);
+        const bool node1_in_commit = (true_node1 >= d_commit_min) && (true_node1 < d_commit_max);
+        const bool node2_in_commit = (true_node2 >= 0) && (true_node2 >= d_commit_min) && (true_node2 < d_commit_max);
 
         if (!node1_in_commit && !node2_in_commit)
         {
@@ -135,44 +594,54 @@ SLIDING_PYMATCHING::decode_window(syndrome_ref syndrome,
                 debug_strm << "\tskipping edge between " << true_node1 << " and " << true_node2 
                     << " (both outside commit region)\n";
             }
-            continue;  // Skip edges entirely outside commit region
+            return;  // Skip edges entirely outside commit region
         }
 
-        if ((opts.do_not_commit_any_boundary_edges || opts.do_not_commit_boundary_edges_set.count(true_node1))
-            && node2 < 0)
+        if (node2 < 0 && !dopts.commits_boundary(true_node1))
         {
             if (GL_DEBUG_DECODER)
             {
                 debug_strm << "\tskipping edge between " << true_node1 << " and " << true_node2 
                     << " (touches boundary)\n";
             }
-            continue;  // Skip edges touching boundary
+            return;  // Skip edges touching boundary
         }
 
-        // Regular edge between two detectors
-        const auto& detector_node = mwpm.search_flooder.graph.nodes[node1];
-        auto* neighbor_ptr = node2 >= 0 ? &mwpm.search_flooder.graph.nodes[node2] : nullptr;
-
-        const size_t neighbor_idx = detector_node.index_of_neighbor(neighbor_ptr);
-        const auto& obs_indices = detector_node.neighbor_observable_indices[neighbor_idx];
-
-        // Apply observable flips
-        for (const size_t obs_idx : obs_indices)
-            obs[obs_idx] ^= 1;
+        // Apply observable flips (an edge on two matched paths is committed twice, which cancels out):
+        if (edge_obs_mask.empty())
+        {
+            const auto& obs_indices = e.detector_node->neighbor_observable_indices[e.neighbor_index];
+            commit.flipped_observables.insert(commit.flipped_observables.end(), obs_indices.begin(), obs_indices.end());
+        }
+        else
+        {
+            commit.obs_mask ^= edge_obs_mask[edge_obs_offset[node1] + e.neighbor_index];
+        }
 
         if (GL_DEBUG_DECODER)
         {
             debug_strm << "\tedge between " << true_node1 << " and " << true_node2 
                 << ", flipped observables:";
-            for (const size_t obs_idx : obs_indices)
+            for (const size_t obs_idx : e.detector_node->neighbor_observable_indices[e.neighbor_index])
                 debug_strm << " " << obs_idx;
-            debug_strm << ", weight = " << detector_node.neighbor_weights[neighbor_idx] << "\n";
+            debug_strm << ", weight = " << e.detector_node->neighbor_weights[e.neighbor_index] << "\n";
         }
 
-        syndrome[true_node1] ^= 1;
+        commit.flipped_detectors.push_back(true_node1);
         if (true_node2 >= 0)
-            syndrome[true_node2] ^= 1;
+            commit.flipped_detectors.push_back(true_node2);
+    };
+
+    for (const auto& match_edge : m.flooder.match_edges)
+    {
+        const size_t node_from = match_edge.loc_from - &m.flooder.graph.nodes[0];
+        const size_t node_to = match_edge.loc_to ? match_edge.loc_to - &m.flooder.graph.nodes[0] : SIZE_MAX;
+        search.iter_edges_on_shortest_path_from_middle(node_from, node_to, _handle_edge);
     }
+    auto t_path = std::chrono::steady_clock::now();
+
+    commit.flood_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t_flood - t_start).count();
+    commit.path_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t_path - t_flood).count();
 }
 
 /////////////////////////////////////////////////////
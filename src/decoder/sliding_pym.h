@@ -7,10 +7,13 @@
 
 #include "decoder/common.h"
 #include "decoder/surface_code.h"
+#include "thread_pool.h"
 
 #include "pymatching/sparse_blossom/driver/mwpm_decoding.h"
 #include "pymatching/sparse_blossom/search/search_detector_node.h"
 
+#include <memory>
+
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
@@ -22,40 +25,241 @@
  *  (1) The first round of the first window is unaffected by CNOT/measurement errors from a prior round (as there
  *      is no previous round). So, the window will span detectors from the first round onward.
  *  (2) Remaining windows will span detectors starting from the second round onward.
+ *
+ * If `parallel_windows` is set, the windows are decoded in two layers ("sandwich" decoding) instead of
+ * in sequence:
+ *  (A) Windows of `window_size` rounds, each with a core of `commit_size` rounds and a buffer of
+ *      `(window_size - commit_size)/2` rounds on either side. Only matches that touch the core are
+ *      committed. The cores are `commit_size + 2*buffer` rounds apart, so the windows do not overlap.
+ *  (B) Windows covering the gaps between the cores (i.e. the buffers of two neighboring A windows).
+ *      Both sides of a gap have been committed, so these windows commit everything.
+ * The windows of one layer are independent: each is matched against the syndrome at the start of its
+ * layer, and the corrections of the whole layer are applied afterwards. So, a layer can be decoded on
+ * `num_threads` threads.
+ *
+ * If `pipelined_windows` is set, the sequential windows are decoded two at a time: window k is matched on
+ * the calling thread, while window k+1 is matched speculatively on a second thread, using the syndrome
+ * before window k's corrections. If window k's commit flips no detector past its commit region, window k+1
+ * (and where it starts) is unaffected by the commit, so the speculative result is the sequential result and
+ * is applied directly. Otherwise, the speculative result is dropped and window k+1 is decoded again in the
+ * next step. Either way, the prediction is the same as with sequential decoding.
+ *
+ * Rounds can also be streamed one at a time with `push_round`. A window is decoded as soon as `window_size`
+ * rounds are buffered, its first `commit_size` rounds are committed, and only the remaining rounds are kept,
+ * along with the last committed round (the window circuit starts one round before the window, so commits
+ * can flip its detectors). `finish` decodes the rest and returns the prediction. Streaming always uses
+ * sequential windows, and its memory is bounded by `window_size+1` rounds. Defects that a window leaves uncommitted (see `decode_options`)
+ * are dropped with their rounds, and can be collected with `take_stream_leftovers`.
  * */
 
 class SLIDING_PYMATCHING
 {
 public:
+    // commit policy. This is meant to be built once per decoder and passed by reference to every decode:
     struct decode_options
     {
-        // do not commit any boundary edges for detectors in this set:
-        std::unordered_set<GRAPH_COMPONENT_ID> do_not_commit_boundary_edges_set{};
+        // do not commit any boundary edges for the detectors set in this mask (bit `d%64` of word `d/64`).
+        // Detectors past the end of the mask are committed:
+        std::vector<uint64_t> do_not_commit_boundary_mask{};
 
         bool do_not_commit_any_boundary_edges{false};
+
+        void do_not_commit_boundary(uint64_t d)
+        {
+            if (d/64 >= do_not_commit_boundary_mask.size())
+                do_not_commit_boundary_mask.resize(d/64 + 1, 0);
+            do_not_commit_boundary_mask[d/64] |= uint64_t{1} << (d%64);
+        }
+
+        bool commits_boundary(uint64_t d) const
+        {
+            if (do_not_commit_any_boundary_edges)
+                return false;
+            return d/64 >= do_not_commit_boundary_mask.size() || !((do_not_commit_boundary_mask[d/64] >> (d%64)) & 1);
+        }
     };
 
     using window_bounds_type = std::tuple<GRAPH_COMPONENT_ID, GRAPH_COMPONENT_ID, GRAPH_COMPONENT_ID>;
 
+    struct options
+    {
+        bool   parallel_windows{false};
+        size_t num_threads{1};
+
+        // speculative two-window pipeline (sequential windows, always uses two threads):
+        bool   pipelined_windows{false};
+
+        // adaptive windows (sequential decoding only). The window circuit still bounds each window at
+        // `window_size` rounds. See `adaptive_window_bounds`.
+        bool   adaptive_windows{false};
+        size_t adaptive_quiet_rounds{0};  // 0 = `commit_size`
+        size_t adaptive_min_buffer{0};    // 0 = `(window_size - commit_size)/2`
+    };
+
+    // statistics over the sequential windows decoded so far:
+    struct window_stats
+    {
+        uint64_t windows{0};
+        uint64_t commit_rounds{0};
+        uint64_t window_rounds{0};
+
+        // time spent flooding (matching the defects), tracing the matched paths, and applying the commit:
+        uint64_t flood_ns{0};
+        uint64_t path_ns{0};
+        uint64_t commit_ns{0};
+
+        uint64_t isolated_windows{0};  // adaptive: windows that were cut at a quiet run
+        uint64_t grown_buffers{0};     // adaptive: windows that used the full buffer
+
+        uint64_t speculated_windows{0};  // pipelined: windows matched before the previous commit
+        uint64_t speculation_hits{0};    // pipelined: speculative results that were applied
+    };
+
     const size_t commit_size;
     const size_t window_size;
     const size_t detectors_per_round;
     const size_t total_rounds;
 private:
+    // corrections of one window, applied once every window in the layer has been matched:
+    struct window_commit
+    {
+        std::vector<GRAPH_COMPONENT_ID> flipped_detectors;
+        std::vector<size_t>             flipped_observables;  // only used with more than 64 observables
+        pm::obs_int                     obs_mask{0};
+
+        uint64_t flood_ns{0};
+        uint64_t path_ns{0};
+    };
+
+    // a sequential window: it starts at round `r`, and `window_rounds == 0` if no window is left:
+    struct window_plan
+    {
+        size_t r{0};
+        size_t window_rounds{0};
+        size_t commit_rounds{0};
+
+        bool isolated{false};
+        bool grown{false};
+    };
+
     pm::Mwpm mwpm;
+
+    // observables of each search graph edge: the edge from node `i` to its `k`-th neighbor is at
+    // `edge_obs_offset[i] + k`. Only built if there are at most 64 observables. All matchers share the
+    // table, as they are built from the same circuit.
+    std::vector<uint32_t>    edge_obs_offset;
+    std::vector<pm::obs_int> edge_obs_mask;
+
+    // `parallel_windows` and `pipelined_windows` only: one matcher for each thread except the caller
+    // (which uses `mwpm`):
+    std::vector<pm::Mwpm>        worker_mwpm;
+    std::unique_ptr<THREAD_POOL> thread_pool;
+
+    // streaming state: `stream_syndrome` holds `stream_rounds` rounds, starting from `stream_first_round`. After
+    // the first window, the first of these is the last committed round (`stream_has_lead`), so that buffer
+    // indices are window circuit indices (the window circuit starts one round before the window):
+    syndrome_type stream_syndrome;
+    syndrome_type stream_obs{DEFAULT_OBS_BIT_WIDTH};
+    size_t        stream_first_round{0};
+    size_t        stream_rounds{0};
+    bool          stream_has_lead{false};
+
+    std::vector<GRAPH_COMPONENT_ID> stream_leftovers;
+
+    window_stats stats;
+
+    const options opts;
 public:
     SLIDING_PYMATCHING(const stim::Circuit&, 
                             size_t commit_size, 
                             size_t window_size, 
                             size_t detectors_per_round,
                             size_t total_rounds);
+    SLIDING_PYMATCHING(const stim::Circuit&, 
+                            size_t commit_size, 
+                            size_t window_size, 
+                            size_t detectors_per_round,
+                            size_t total_rounds,
+                            options);
 
     DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm);
 
     // generic decode function:
-    void decode_and_update_inplace(syndrome_ref, syndrome_ref, std::ostream& debug_strm, decode_options);
+    void decode_and_update_inplace(syndrome_ref, syndrome_ref, std::ostream& debug_strm, const decode_options&);
+
+    // streaming: `round_detectors` has the `detectors_per_round` detector bits of the next round.
+    // `finish` returns the prediction for all pushed rounds and resets the stream.
+    void           push_round(syndrome_ref round_detectors, std::ostream& debug_strm);
+    void           push_round(syndrome_ref round_detectors, std::ostream& debug_strm, const decode_options&);
+    DECODER_RESULT finish(std::ostream& debug_strm);
+    DECODER_RESULT finish(std::ostream& debug_strm, const decode_options&);
+
+    // returns (and clears) the uncommitted defects of the rounds dropped so far, as detector ids from
+    // the start of the stream. Every round before `stream_committed_rounds()` is final:
+    std::vector<GRAPH_COMPONENT_ID> take_stream_leftovers();
+    size_t                          stream_committed_rounds() const { return stream_first_round; }
+
+    const window_stats& get_window_stats() const { return stats; }
 private:
-    void decode_window(syndrome_ref, syndrome_ref, window_bounds_type, std::ostream&, decode_options); 
+    // returns the first window with a defect in its commit region, for windows starting at or after round `r`.
+    // Defects before round `r` are outside every remaining window, so they are ignored:
+    window_plan plan_window(size_t r, const std::vector<uint32_t>& defects_by_round) const;
+
+    /*
+     * Returns the window and its commit region for a window starting at round `r` (which has a defect):
+     *  (1) If a run of `adaptive_quiet_rounds` defect-free rounds starts within the window, the defects before
+     *      the run are treated as an isolated cluster: the window ends at the run, and all of it is committed.
+     *      Quiet stretches therefore cost nothing, and a commit region can extend past `commit_size` rounds.
+     *  (2) Otherwise, `commit_size` rounds are committed with a buffer of `adaptive_min_buffer` rounds. If any
+     *      defect lies near the commit boundary, the buffer grows to `window_size - commit_size` rounds.
+     * */
+    window_plan adaptive_window_bounds(size_t r, const std::vector<uint32_t>& defects_by_round) const;
+
+    window_bounds_type plan_bounds(const window_plan&) const;
+    void               record_plan(const window_plan&);
+
+    // `defects_by_round` is updated with the committed corrections:
+    void decode_window(syndrome_ref, 
+                        syndrome_ref, 
+                        window_bounds_type, 
+                        std::vector<uint32_t>& defects_by_round, 
+                        std::ostream&, 
+                        const decode_options&); 
+
+    void decode_parallel(syndrome_ref, syndrome_ref, std::ostream&, const decode_options&);
+    void decode_pipelined(syndrome_ref, 
+                            syndrome_ref, 
+                            std::vector<uint32_t>& defects_by_round, 
+                            std::ostream&, 
+                            const decode_options&);
+    
+    // runs a layer of windows (see `decode_parallel`) on the thread pool:
+    void decode_layer(syndrome_ref, 
+                        syndrome_ref, 
+                        const std::vector<window_bounds_type>&, 
+                        const std::vector<GRAPH_COMPONENT_ID>& commit_min,
+                        std::ostream&, 
+                        const decode_options&);
+
+    // matches the window and records the corrections for matches that touch the commit region
+    // [`commit_min`, `commit_max`). `syndrome` is only read. `offset` is the number of detectors that
+    // precede the window's first round in the window circuit (see above).
+    void match_window(pm::Mwpm&, 
+                        syndrome_ref, 
+                        window_bounds_type, 
+                        GRAPH_COMPONENT_ID commit_min, 
+                        size_t offset,
+                        window_commit&, 
+                        std::ostream&, 
+                        const decode_options&);
+
+    size_t window_offset(GRAPH_COMPONENT_ID d_min) const { return (d_min == 0) ? 0 : detectors_per_round; }
+
+    // if `defects_by_round` is not null, it is updated as the detectors are flipped:
+    void apply_commit(syndrome_ref, syndrome_ref, const window_commit&, uint32_t* defects_by_round) const;
+
+    // decodes the buffered rounds and drops the first `commit_size` of them:
+    void stream_commit(std::ostream&, const decode_options&);
 };
 
 /////////////////////////////////////////////////////
@@ -6,9 +6,14 @@
 #include "decoder/surface_code.h"
 #include "decoder/sliding_pym.h"
 #include "graph/distance.h"
+#include "io/dg_cache.h"
 
+#include <bit>
 #include <iostream>
+#include <limits>
 #include <mutex>
+#include <numeric>
+#include <optional>
 #include <thread>
 
 #include <PerfectMatching.h>
@@ -18,26 +23,40 @@ extern bool GL_DEBUG_DECODER;
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+constexpr stim::DemOptions SC_DEM_OPTS
+{
+    true,  // decompose_errors
+    true,  // flatten_loops
+    false, // allow_gauge_detectors
+    0.0,   // approximate_disjoint_errors_threshold
+    false, // ignore_decomposition_failures
+    false  // block_decomposition_from_introducing_remnant_edges
+};
+
 SC_DECODING_GRAPH*
-create_sc_decoding_graph_from_circuit(const stim::Circuit& circuit)
+create_sc_decoding_graph_from_circuit(const stim::Circuit& circuit, size_t num_threads)
 {
-    constexpr stim::DemOptions SC_DEM_OPTS
-    {
-        true,  // decompose_errors
-        true,  // flatten_loops
-        false, // allow_gauge_detectors
-        0.0,   // approximate_disjoint_errors_threshold
-        false, // ignore_decomposition_failures
-        false  // block_decomposition_from_introducing_remnant_edges
-    };
+    uint64_t cache_key{0};
+    if (!GL_DG_CACHE_DIR.empty())
+    {
+        cache_key = io::dg_cache_key(circuit, SC_DEM_OPTS, io::DG_CACHE_KIND::SC_DECODING_GRAPH);
+        if (auto* dg = io::load_sc_decoding_graph(cache_key))
+        {
+            compute_all_edge_observable_masks(dg);
+            return dg;
+        }
+    }
 
     stim::DetectorErrorModel dem = stim::circuit_to_dem(circuit, SC_DEM_OPTS);
 
     if (search_for_bad_dem_errors(dem, circuit))
         throw std::runtime_error("SC_DECODING_GRAPH: found bad DEM errors");
 
-    auto* dg = read_surface_code_decoding_graph(dem);
+    auto* dg = read_surface_code_decoding_graph(dem, num_threads);
     quantize_all_edge_weights(dg);
+    compute_all_edge_observable_masks(dg);
+
+    io::store_sc_decoding_graph(cache_key, *dg, circuit.count_observables());
     return dg;
 }
 
@@ -48,48 +67,277 @@ create_sc_decoding_graph_from_circuit(const stim::Circuit& circuit)
  * Blossom-V Implementation:
  * */
 
+constexpr auto DIJKSTRA_WF = [] (const auto* e) { return e->data.quantized_weight; };
+constexpr auto DIJKSTRA_PF = [] (const auto* e) { return e->data.observable_mask; };
+
 BLOSSOM5::BLOSSOM5(const stim::Circuit& circuit)
-    :dg{create_sc_decoding_graph_from_circuit(circuit)},
-    boundary_id(dg->get_vertices().size()-1)
+    :BLOSSOM5(circuit, options{})
 {
 }
 
+BLOSSOM5::BLOSSOM5(const stim::Circuit& circuit, options opts)
+    :dg{create_sc_decoding_graph_from_circuit(circuit, opts.num_build_threads)},
+    boundary_id(dg->get_vertices().size()-1),
+    use_parity_labels(circuit.count_observables() <= 8*sizeof(parity_type)),
+    opts(opts)
+{
+    if (opts.num_decode_threads > 1)
+        thread_pool = std::make_unique<THREAD_POOL>(opts.num_decode_threads);
+
+    if (opts.distance_table_max_bytes == 0 || !use_parity_labels)
+        return;
+
+    const size_t num_threads = opts.num_build_threads > 0 ? opts.num_build_threads : std::thread::hardware_concurrency();
+    distance_table = std::make_unique<distance_table_type>(
+                            *dg, 
+                            DIJKSTRA_WF, 
+                            DIJKSTRA_PF,
+                            opts.distance_table_max_bytes,
+                            num_threads,
+                            std::vector<GRAPH_COMPONENT_ID>{boundary_id});
+}
+
 ///////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////
 
-constexpr auto DIJKSTRA_WF = [] (const auto* e) { return e->data.quantized_weight; };
+BLOSSOM5::matching_problem
+BLOSSOM5::compute_distances(std::vector<GRAPH_COMPONENT_ID> dets) const
+{
+    const size_t n = dets.size();
+
+    constexpr distance_type INF{std::numeric_limits<distance_type>::max()};
+
+    matching_problem prob;
+    prob.pair_dist.assign(n*n, INF);
+    prob.boundary_dist.resize(n);
+    prob.flood_index.assign(n, -1);
+    prob.batch_size = (opts.multi_source_batch_size > 0) ? opts.multi_source_batch_size : n;
+
+    auto& pair_dist = prob.pair_dist;
+    auto& boundary_dist = prob.boundary_dist;
+    auto& flood_index = prob.flood_index;
+
+    // distances to the boundary come from the table (whose boundary row is always complete),
+    // or from a single search out of the boundary:
+    if (distance_table)
+    {
+        for (size_t i = 0; i < n; i++)
+            boundary_dist[i] = distance_table->lookup(dets[i], boundary_id)->dist;
+    }
+    else
+    {
+        dijkstra_ws.run_with_parity(*dg, boundary_id, DIJKSTRA_WF, DIJKSTRA_PF, true, dets.cbegin(), dets.cend());
+        for (size_t i = 0; i < n; i++)
+            boundary_dist[i] = dijkstra_ws.dist(dets[i]);
+    }
+
+    // pairwise distances come from the table where possible. Defects with a miss become sources of one
+    // multi-source search. Since `d(i,j) <= d(i,B) + d(j,B)` (via the boundary), the search does not need 
+    // to expand the boundary, and source `i` only needs to find `j` if `d(i,j) < d(i,B) + d(j,B)`.
+    std::vector<GRAPH_COMPONENT_ID> flood_sources;
+    std::vector<size_t> flood_first_target;
+    std::vector<distance_type> flood_source_radius;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = i+1; j < n; j++)
+        {
+            auto table_result = distance_table ? distance_table->lookup(dets[i], dets[j]) : std::nullopt;
+            if (table_result.has_value())
+                pair_dist[i*n+j] = table_result->dist;
+            else if (flood_index[i] < 0)
+                flood_index[i] = static_cast<int32_t>(flood_sources.size());
+        }
+
+        if (flood_index[i] >= 0)
+        {
+            flood_sources.push_back(dets[i]);
+            flood_first_target.push_back(i+1);
+            flood_source_radius.push_back(boundary_dist[i]);
+        }
+    }
+
+    // sources are grown in batches: a batch shares one queue, but a smaller batch keeps its labels
+    // in cache, which matters more for large `n`.
+    const size_t batch_size = prob.batch_size;
+    const size_t num_batches = (flood_sources.size() + batch_size - 1) / batch_size;
+    if (multi_source_ws.size() < num_batches)
+        multi_source_ws.resize(num_batches);
+
+    // batches are independent (each has its own workspace), so large shots can spread them over the pool:
+    auto _run_batch = [&] (size_t b, size_t)
+    {
+        const size_t s_begin = b*batch_size,
+                     s_end = std::min(flood_sources.size(), s_begin + batch_size);
+        std::vector<GRAPH_COMPONENT_ID> batch_sources(flood_sources.begin()+s_begin, flood_sources.begin()+s_end);
+        std::vector<size_t> batch_first_target(flood_first_target.begin()+s_begin, flood_first_target.begin()+s_end);
+        std::vector<distance_type> batch_radius(flood_source_radius.begin()+s_begin, flood_source_radius.begin()+s_end);
+
+        multi_source_ws[b].run_with_parity(*dg, DIJKSTRA_WF, DIJKSTRA_PF, batch_sources, dets, batch_first_target, 
+                                            batch_radius, boundary_dist, boundary_id);
+    };
+
+    if (thread_pool && n >= opts.parallel_hamming_weight_threshold)
+    {
+        thread_pool->parallel_for(num_batches, _run_batch);
+    }
+    else
+    {
+        for (size_t b = 0; b < num_batches; b++)
+            _run_batch(b, 0);
+    }
+
+    prob.dets = std::move(dets);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (flood_index[i] < 0)
+            continue;
+        for (size_t j = i+1; j < n; j++)
+        {
+            if (pair_dist[i*n+j] != INF)
+                continue;
+            int64_t through_boundary = static_cast<int64_t>(boundary_dist[i]) + boundary_dist[j];
+            int64_t d = std::min<int64_t>(flood_dist(prob, i, j), through_boundary);
+            pair_dist[i*n+j] = static_cast<distance_type>(std::min<int64_t>(d, INF));
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = i+1; j < n; j++)
+            pair_dist[j*n+i] = pair_dist[i*n+j];
+
+    return prob;
+}
+
+BLOSSOM5::distance_type
+BLOSSOM5::flood_dist(const matching_problem& prob, size_t i, size_t j) const
+{
+    const size_t s = prob.flood_index[i];
+    return multi_source_ws[s / prob.batch_size].dist(s % prob.batch_size, j);
+}
+
+BLOSSOM5::parity_type
+BLOSSOM5::path_parity(const matching_problem& prob, size_t i, size_t j) const
+{
+    const size_t n = prob.size();
+    if (j < i)
+        std::swap(i, j);
+
+    auto _boundary_parity = [this, &prob] (size_t k) -> parity_type
+    {
+        return distance_table ? distance_table->lookup(prob.dets[k], boundary_id)->parity 
+                              : dijkstra_ws.parity(prob.dets[k]);
+    };
+
+    if (j == n)
+        return _boundary_parity(i);
+
+    auto table_result = distance_table ? distance_table->lookup(prob.dets[i], prob.dets[j]) : std::nullopt;
+    if (table_result.has_value())
+        return table_result->parity;
+
+    if (flood_dist(prob, i, j) == prob.pair_dist[i*n+j])
+    {
+        const size_t s = prob.flood_index[i];
+        return multi_source_ws[s / prob.batch_size].parity(s % prob.batch_size, j);
+    }
+
+    // the shortest path goes through the boundary:
+    return _boundary_parity(i) ^ _boundary_parity(j);
+}
+
+///////////////////////////////////////////////////////
+///////////////////////////////////////////////////////
 
 DECODER_RESULT
 BLOSSOM5::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm) const
 {
-    // add boundary if odd number of dets:
-    if (dets.size() & 1)
-        dets.push_back(boundary_id);
-
-    // initialize b5 object
     const size_t n = dets.size();
-    const size_t m = (n*(n-1)) >> 1;
-    b5::PerfectMatching pm(n, m);
-    pm.options.verbose = false;
+    if (n == 0)
+        return DECODER_RESULT{};
 
-    std::vector<graph::DIJKSTRA_RESULT<weight_type>> dijkstra_results(n);
+    const matching_problem prob = compute_distances(std::move(dets));
+    const auto& pair_dist = prob.pair_dist;
+    const auto& boundary_dist = prob.boundary_dist;
 
-    for (size_t i = 0; i < n; i++)
+    // select the defect pairs that get an edge:
+    std::vector<std::pair<size_t, size_t>> pair_edges;
+    if (opts.sparse_matching)
     {
-        auto et_begin = dets.begin()+i,
-             et_end = dets.end();
-        auto result = graph::dijkstra<weight_type>(*dg, dets[i], DIJKSTRA_WF, true, et_begin, et_end);
-        for (size_t j = i+1; j < n; j++)
+        // if `d(i,j) >= d(i,B) + d(j,B)`, then matching `i` and `j` to their boundary copies costs no more
+        // than matching them together, so the edge can be dropped without changing the optimal weight.
+        std::vector<bool> keep(n*n, false);
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = i+1; j < n; j++)
+                keep[i*n+j] = !prob.through_boundary(i, j);
+
+        // the k nearest neighbors are not needed for optimality, but give Blossom V more
+        // candidate edges to grow trees along:
+        if (opts.sparse_knn > 0)
         {
-            pm.AddEdge(i, j, result.dist[dets[j]]);
+            std::vector<size_t> order(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                std::iota(order.begin(), order.end(), 0);
+                std::swap(order[i], order.back());
+                const size_t k = std::min(opts.sparse_knn, n-1);
+                std::partial_sort(order.begin(), order.begin()+k, order.end()-1,
+                                    [&pair_dist, i, n] (size_t x, size_t y) 
+                                    { 
+                                        return pair_dist[i*n+x] < pair_dist[i*n+y]; 
+                                    });
+                for (size_t x = 0; x < k; x++)
+                    keep[std::min(i, order[x])*n + std::max(i, order[x])] = true;
+            }
+        }
+
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = i+1; j < n; j++)
+                if (keep[i*n+j])
+                    pair_edges.emplace_back(i, j);
+    }
+    else
+    {
+        pair_edges.reserve((n*(n-1)) >> 1);
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = i+1; j < n; j++)
+                pair_edges.emplace_back(i, j);
+    }
+
+    // node layout: defects are nodes [0, n). In the sparse graph, node `n+i` is the boundary copy of
+    // defect `i`, and boundary copies are connected by zero-weight edges that mirror the defect edges.
+    // In the dense graph, node `n` is a single boundary node, which only exists if `n` is odd.
+    size_t num_nodes, num_edges;
+    if (opts.sparse_matching)
+    {
+        num_nodes = 2*n;
+        num_edges = n + 2*pair_edges.size();
+    }
+    else
+    {
+        num_nodes = n + (n & 1);
+        num_edges = pair_edges.size() + ((n & 1) ? n : 0);
+    }
+
+    b5::PerfectMatching pm(num_nodes, num_edges);
+    pm.options.verbose = false;
+
+    for (const auto& [i, j] : pair_edges)
+    {
+        pm.AddEdge(i, j, pair_dist[i*n+j]);
+        if (opts.sparse_matching)
+            pm.AddEdge(n+i, n+j, 0);
 
 #if defined(DEBUG_DECODER)
-            debug_strm << "added edge between " << dets[i] << " and " << dets[j] 
-                        << " with weight " << result.dist[dets[j]] << "\n";
+        debug_strm << "added edge between " << prob.dets[i] << " and " << prob.dets[j] 
+                    << " with weight " << pair_dist[i*n+j] << "\n";
 #endif
-        }
+    }
 
-        dijkstra_results[i] = std::move(result);
+    if (opts.sparse_matching || (n & 1))
+    {
+        for (size_t i = 0; i < n; i++)
+            pm.AddEdge(i, opts.sparse_matching ? n+i : n, boundary_dist[i]);
     }
 
     pm.Solve(); 
@@ -97,18 +345,9 @@ BLOSSOM5::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm)
     // determine frame changes -- it is faster to just count the parity
     // of observable flips rather than modifying a set over and over again
     DECODER_RESULT result;
-    for (size_t i = 0; i < n; i++)
-    {
-        size_t j = pm.GetMatch(i);
-        if (j < i)  // avoid double counting
-            continue;
-
-        auto dijk_result = std::move(dijkstra_results[i]);
-
-        GRAPH_COMPONENT_ID src_id = dets[i],
-                           dst_id = dets[j];
 
-        auto id_path = graph::dijkstra_path(dijk_result.prev, src_id, dst_id, true);
+    auto _apply_path = [this, &result] (const std::vector<GRAPH_COMPONENT_ID>& id_path, [[ maybe_unused ]] std::ostream& strm)
+    {
         std::vector<SC_DECODING_GRAPH::VERTEX*> vertex_path(id_path.size());
         std::transform(id_path.begin(), id_path.end(), vertex_path.begin(),
                         [this] (GRAPH_COMPONENT_ID id) { return dg->get_vertex(id); });
@@ -125,12 +364,50 @@ BLOSSOM5::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_strm)
         }
 
 #if defined (DEBUG_DECODER)
-        debug_strm << "match between " << src_id << " and " << dst_id << ", flipped observables:";
+        strm << "path " << id_path.front() << " -> " << id_path.back() << ", flipped observables:";
         for (const auto& [x, flips] : path_flips)
             if (flips & 1)
-                debug_strm << " " << x;
-        debug_strm << "\n";
+                strm << " " << x;
+        strm << "\n";
+#endif
+    };
+
+    // without parity labels (i.e., more than 64 observables), the matched paths are walked:
+    auto _apply_boundary_path = [&] (size_t i)
+    {
+        _apply_path(dijkstra_ws.path(boundary_id, prob.dets[i], true), debug_strm);
+    };
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t j = pm.GetMatch(i);
+        if (j < i)  // avoid double counting
+            continue;
+        j = std::min(j, n);
+
+#if defined (DEBUG_DECODER)
+        debug_strm << "match between " << prob.dets[i] << " and " << (j < n ? prob.dets[j] : boundary_id) << "\n";
 #endif
+
+        if (use_parity_labels)
+        {
+            result.flipped_observables.u64[0] ^= path_parity(prob, i, j);
+        }
+        else if (j == n)
+        {
+            _apply_boundary_path(i);
+        }
+        else if (flood_dist(prob, i, j) == pair_dist[i*n+j])
+        {
+            const size_t s = prob.flood_index[i];
+            _apply_path(multi_source_ws[s / prob.batch_size].path(s % prob.batch_size, j), debug_strm);
+        }
+        else
+        {
+            // the shortest path goes through the boundary:
+            _apply_boundary_path(i);
+            _apply_boundary_path(j);
+        }
     }
 
     return result;
@@ -172,6 +449,47 @@ PYMATCHING::decode(std::vector<GRAPH_COMPONENT_ID> dets, std::ostream& debug_str
     return result;
 }
 
+void
+PYMATCHING::decode_batch(const syndrome_table_type& detector_table, size_t num_shots, syndrome_table_type& prediction_table)
+{
+    prediction_table.clear();
+    batch_obs.resize(num_observables);
+
+    const bool use_obs_mask = num_observables <= 8*sizeof(pm::obs_int);
+    for (size_t s = 0; s < num_shots; s++)
+    {
+        // extract the flipped detectors a word at a time (most words are zero):
+        batch_events.clear();
+        const auto row = detector_table[s];
+        for (size_t w = 0; w < row.num_u64_padded(); w++)
+        {
+            for (uint64_t bits = row.u64[w]; bits; bits &= bits-1)
+                batch_events.push_back(64*w + std::countr_zero(bits));
+        }
+
+        if (batch_events.empty())
+            continue;
+
+        if (use_obs_mask)
+        {
+            auto res = pm::decode_detection_events_for_up_to_64_observables(mwpm, batch_events, false);
+            for (pm::obs_int mask = res.obs_mask; mask; mask &= mask-1)
+                prediction_table[std::countr_zero(mask)][s] = 1;
+        }
+        else
+        {
+            std::fill(batch_obs.begin(), batch_obs.end(), 0);
+            pm::total_weight_int weight{0};
+            pm::decode_detection_events(mwpm, batch_events, batch_obs.data(), weight, false);
+            for (size_t o = 0; o < num_observables; o++)
+            {
+                if (batch_obs[o])
+                    prediction_table[o][s] = 1;
+            }
+        }
+    }
+}
+
 void
 PYMATCHING::decode_with_debug_info(std::vector<uint64_t>&& detection_events, syndrome_ref obs, std::ostream& debug_strm)
 {
@@ -209,8 +527,19 @@ PYMATCHING::decode_with_debug_info(std::vector<uint64_t>&& detection_events, syn
 pm::Mwpm 
 pymatching_create_mwpm_from_circuit(const stim::Circuit& circuit, bool enable_search_flooder)
 {
-    auto dem = stim::circuit_to_dem(circuit, {true, true, false, 0.0, false, false});
-    return pm::detector_error_model_to_mwpm(dem, pm::NUM_DISTINCT_WEIGHTS, enable_search_flooder, false);
+    uint64_t cache_key{0};
+    if (!GL_DG_CACHE_DIR.empty())
+    {
+        cache_key = io::dg_cache_key(circuit, SC_DEM_OPTS, io::DG_CACHE_KIND::PYMATCHING_USER_GRAPH);
+        if (auto ug = io::load_pymatching_user_graph(cache_key))
+            return ug->to_mwpm(pm::NUM_DISTINCT_WEIGHTS, enable_search_flooder);
+    }
+
+    // this is equivalent to `pm::detector_error_model_to_mwpm`, but we keep the user graph for the cache:
+    auto dem = stim::circuit_to_dem(circuit, SC_DEM_OPTS);
+    auto ug = pm::detector_error_model_to_user_graph(dem, false, pm::NUM_DISTINCT_WEIGHTS);
+    io::store_pymatching_user_graph(cache_key, ug);
+    return ug.to_mwpm(pm::NUM_DISTINCT_WEIGHTS, enable_search_flooder);
 }
 
 /////////////////////////////////////////////////////
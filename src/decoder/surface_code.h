@@ -8,6 +8,10 @@
 
 #include "decoding_graph.h"
 #include "decoder/common.h"
+#include "graph/distance.h"
+#include "graph/distance_table.h"
+#include "graph/multi_source.h"
+#include "thread_pool.h"
 
 #include <stim/circuit/circuit.h>
 #include <stim/dem/detector_error_model.h>
@@ -19,10 +23,14 @@
 #include <pymatching/sparse_blossom/flooder_matcher_interop/compressed_edge.h>
 
 #include <iosfwd>
+#include <string>
 
 // Global debug configuration variable
 extern bool GL_DEBUG_DECODER;
 
+// Decoding graph cache directory (see `io/dg_cache.h`), empty = disabled
+extern std::string GL_DG_CACHE_DIR;
+
 /*
  * This file contains all decoders for the surface code.
  * The simple-to-implement decoders are implemented in `surface_code.cpp`
@@ -49,13 +57,106 @@ class BLOSSOM5
 {
 public:
     using weight_type = DECODER_ERROR_DATA::quantized_weight_type;
+
+    // path lengths are sums of quantized weights, so they need a wider type:
+    using distance_type = int32_t;
+
+    // bitmask of flipped observables (the distance table and parity labels need <= 64 observables)
+    using parity_type = uint64_t;
+
+    using distance_table_type = graph::DISTANCE_TABLE<distance_type, parity_type>;
+
+    // distances are sums of non-negative integers, so the searches can use a radix heap:
+    using dijkstra_workspace_type = graph::DIJKSTRA_WORKSPACE<distance_type, graph::RADIX_HEAP_QUEUE<distance_type>>;
+    using multi_source_workspace_type = graph::MULTI_SOURCE_WORKSPACE<distance_type, graph::RADIX_HEAP_QUEUE<distance_type>>;
+
+    struct options
+    {
+        // memory budget for the precomputed distance table. If the full table does not fit,
+        // a radius-bounded table is built instead. Set to 0 to always run `dijkstra`.
+        size_t distance_table_max_bytes{256ull << 20};
+
+        // threads used to build the decoding graph and the distance table. With 0, the decoding
+        // graph is built sequentially and the distance table uses hardware concurrency.
+        size_t num_build_threads{0};
+
+        // give each defect its own boundary copy and drop defect pairs that are no closer to each
+        // other than to the boundary. The matching weight is the same as with the complete graph,
+        // but Blossom V is not always faster on the sparse graph (it has twice as many nodes).
+        bool sparse_matching{false};
+
+        // if `sparse_matching` is set, also keep edges to each defect's `sparse_knn` nearest defects.
+        size_t sparse_knn{0};
+
+        // number of defects grown together by one multi-source search when the distance table
+        // misses (0 = all defects at once).
+        size_t multi_source_batch_size{8};
+
+        // threads used to run the multi-source batches of a single shot. Shots with fewer than
+        // `parallel_hamming_weight_threshold` defects always run on the calling thread.
+        size_t num_decode_threads{1};
+        size_t parallel_hamming_weight_threshold{64};
+    };
 private:
     std::unique_ptr<SC_DECODING_GRAPH> dg;
 
     GRAPH_COMPONENT_ID boundary_id;
+
+    // if the circuit has at most 64 observables, searches label each vertex with the observables
+    // flipped along its path, so matched paths never need to be walked.
+    bool use_parity_labels;
+
+    std::unique_ptr<distance_table_type> distance_table;
+
+    // reused by every search in `decode` (so `decode` is not reentrant):
+    mutable dijkstra_workspace_type                  dijkstra_ws;
+    mutable std::vector<multi_source_workspace_type> multi_source_ws;  // one per batch
+
+    std::unique_ptr<THREAD_POOL> thread_pool;
+
+    const options opts;
 public:
+    /*
+     * Distances between the defects of one shot. Defect `i` is `dets[i]`, and index `size()` stands
+     * for the boundary. `pair_dist` already accounts for paths through the boundary. The flood results
+     * live in the decoder's workspaces, so a problem is only valid until the next call to `compute_distances`.
+     * */
+    struct matching_problem
+    {
+        std::vector<GRAPH_COMPONENT_ID> dets;
+        std::vector<distance_type>      pair_dist;      // `size() x size()`, row-major
+        std::vector<distance_type>      boundary_dist;
+
+        // index of each defect among the multi-source search sources (-1 if the table had all its pairs):
+        std::vector<int32_t> flood_index;
+        size_t               batch_size;
+
+        size_t        size() const { return dets.size(); }
+        distance_type dist(size_t i, size_t j) const { return (j == size()) ? boundary_dist[i] : pair_dist[i*size()+j]; }
+
+        // true if the shortest path between `i` and `j` is no shorter than going through the boundary:
+        bool through_boundary(size_t i, size_t j) const 
+        { 
+            return static_cast<int64_t>(pair_dist[i*size()+j]) >= static_cast<int64_t>(boundary_dist[i]) + boundary_dist[j];
+        }
+    };
+
     BLOSSOM5(const stim::Circuit&);
+    BLOSSOM5(const stim::Circuit&, options);
     DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm) const;
+
+    matching_problem compute_distances(std::vector<GRAPH_COMPONENT_ID>) const;
+
+    // observables flipped by the shortest path between `i` and `j` (`j == size()` for the boundary).
+    // Requires `has_parity_labels()`.
+    parity_type path_parity(const matching_problem&, size_t i, size_t j) const;
+
+    bool has_parity_labels() const { return use_parity_labels; }
+
+    // `nullptr` if no distance table was built:
+    const distance_table_type* get_distance_table() const { return distance_table.get(); }
+private:
+    distance_type flood_dist(const matching_problem&, size_t i, size_t j) const;
 };
 
 /////////////////////////////////////////////////////
@@ -67,9 +168,23 @@ public:
 private:
     pm::Mwpm mwpm;
     const size_t num_observables;
+
+    // reused by `decode_batch`:
+    std::vector<uint64_t> batch_events;
+    std::vector<uint8_t>  batch_obs;
 public:
     PYMATCHING(const stim::Circuit&);
     DECODER_RESULT decode(std::vector<GRAPH_COMPONENT_ID>, std::ostream& debug_strm);
+
+    /*
+     * Decodes the first `num_shots` rows of `detector_table`, which is indexed [shot][detector] (the transposed
+     * `det_record` of a `stim::FrameSimulator`). The prediction for shot `s` is written to column `s` of
+     * `prediction_table`, which is indexed [observable][shot] like the simulator's `obs_record`, so the
+     * two can be compared a word at a time.
+     * */
+    void decode_batch(const syndrome_table_type& detector_table, size_t num_shots, syndrome_table_type& prediction_table);
+
+    size_t get_num_observables() const { return num_observables; }
 private:
     void decode_with_debug_info(std::vector<uint64_t>&&, syndrome_ref, std::ostream&);
 };
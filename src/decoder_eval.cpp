@@ -0,0 +1,130 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#include "decoder_eval.h"
+
+#include <algorithm>
+#include <bit>
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+size_t
+accumulate_batch_errors(DECODER_STATS& stats,
+                        const syndrome_table_type& prediction_table,
+                        const syndrome_table_type& observable_table,
+                        size_t num_observables,
+                        size_t num_shots,
+                        const DECODER_EVAL_CONFIG& conf)
+{
+    const uint64_t errors_allowed = (conf.stop_at_k_errors > stats.errors) ? conf.stop_at_k_errors - stats.errors : 0;
+    if (num_shots == 0 || errors_allowed == 0)
+        return 0;
+
+    const size_t num_words = (num_shots+63) / 64;
+
+    // `mismatch[o]` has a bit set for each shot where observable `o` was mispredicted:
+    std::vector<syndrome_type> mismatch;
+    mismatch.reserve(num_observables);
+
+    syndrome_type any_mismatch(num_shots);
+    for (size_t o = 0; o < num_observables; o++)
+    {
+        const auto pred = prediction_table[o],
+                   obs = observable_table[o];
+        auto& m = mismatch.emplace_back(num_shots);
+        for (size_t w = 0; w < m.num_u64_padded(); w++)
+            m.u64[w] = pred.u64[w] ^ obs.u64[w];
+        any_mismatch |= m;
+    }
+
+    // mask out the shots past `num_shots` (the tables may hold more shots than were decoded):
+    syndrome_type shot_mask(num_shots);
+    for (size_t w = 0; w < num_words; w++)
+        shot_mask.u64[w] = ~uint64_t{0};
+    if (num_shots & 63)
+        shot_mask.u64[num_words-1] = (uint64_t{1} << (num_shots & 63)) - 1;
+
+    // find the shot with the `stop_at_k_errors`-th error, and drop every shot after it:
+    any_mismatch &= shot_mask;
+
+    uint64_t errors{0};
+    size_t trials{num_shots};
+    for (size_t w = 0; w < num_words; w++)
+    {
+        uint64_t word = any_mismatch.u64[w];
+        const uint64_t c = std::popcount(word);
+        if (errors + c < errors_allowed)
+        {
+            errors += c;
+            continue;
+        }
+
+        // the cutoff is in this word: skip to the `(errors_allowed - errors)`-th set bit:
+        for (uint64_t i = errors+1; i < errors_allowed; i++)
+            word &= word-1;
+        trials = 64*w + std::countr_zero(word) + 1;
+        errors = errors_allowed;
+
+        for (size_t x = w+1; x < shot_mask.num_u64_padded(); x++)
+            shot_mask.u64[x] = 0;
+        if (trials & 63)
+            shot_mask.u64[w] &= (uint64_t{1} << (trials & 63)) - 1;
+        break;
+    }
+
+    stats.errors += errors;
+
+    // per-observable and per-basis counts:
+    if (stats.errors_by_observable.size() < num_observables)
+        stats.errors_by_observable.resize(num_observables, 0);
+
+    syndrome_type x_mismatch(num_shots),
+                  z_mismatch(num_shots);
+    for (size_t o = 0; o < num_observables; o++)
+    {
+        auto& m = mismatch[o];
+        m &= shot_mask;
+        stats.errors_by_observable[o] += m.popcnt();
+
+        if (o >= conf.observable_basis.size())
+            continue;
+        if (conf.observable_basis[o] == 'X')
+            x_mismatch |= m;
+        else if (conf.observable_basis[o] == 'Z')
+            z_mismatch |= m;
+    }
+    stats.x_errors += x_mismatch.popcnt();
+    stats.z_errors += z_mismatch.popcnt();
+
+    // joint patterns: errors are rare, so the pattern of each error shot is gathered a word at a time:
+    any_mismatch &= shot_mask;
+
+    const size_t num_pattern_observables = std::min<size_t>(num_observables, 64);
+    std::vector<uint64_t> mismatch_words(num_pattern_observables);
+    for (size_t w = 0; w < num_words; w++)
+    {
+        uint64_t word = any_mismatch.u64[w];
+        if (word == 0)
+            continue;
+
+        for (size_t o = 0; o < num_pattern_observables; o++)
+            mismatch_words[o] = mismatch[o].u64[w];
+
+        for (; word; word &= word-1)
+        {
+            const size_t b = std::countr_zero(word);
+            uint64_t pattern{0};
+            for (size_t o = 0; o < num_pattern_observables; o++)
+                pattern |= ((mismatch_words[o] >> b) & 1) << o;
+            stats.errors_by_pattern[pattern]++;
+        }
+    }
+
+    return trials;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
@@ -10,6 +10,10 @@
 
 #include <stim/circuit/circuit.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
@@ -25,6 +29,17 @@ struct DECODER_STATS
 
     uint64_t errors{0};
     uint64_t trials{0};
+
+    // shots where any X (resp. Z) basis observable was mispredicted (see `DECODER_EVAL_CONFIG::observable_basis`):
+    uint64_t x_errors{0};
+    uint64_t z_errors{0};
+    std::vector<uint64_t> errors_by_observable{};
+
+    // joint failure distribution: maps the set of mispredicted observables in a shot (bit `o` is set if
+    // observable `o` was wrong) to the number of shots with that set. Only shots with an error are recorded,
+    // and only the first 64 observables are tracked.
+    std::map<uint64_t, uint64_t> errors_by_pattern{};
+
     uint64_t trivial_trials{0};
     uint64_t total_time_us{0};
 
@@ -41,16 +56,38 @@ struct DECODER_EVAL_CONFIG
     bool     enable_clock{true};
     uint64_t seed{0};
     uint64_t stop_at_k_errors{25};
+
+    // basis ('X' or 'Z') of each observable. Observables without a basis only count towards `errors`.
+    std::string observable_basis{};
 };
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Batch post-processing: compares `prediction_table` against `observable_table` (both indexed
+ * [observable][shot]) over the first `num_shots` shots, and adds the logical errors (total, per-observable,
+ * and X/Z) to `stats`. Counting stops at the shot with the `stop_at_k_errors`-th error (matching the
+ * per-shot loop), and the number of shots counted is returned. `stats.trials` is not updated.
+ * */
+
+size_t accumulate_batch_errors(DECODER_STATS&,
+                                const syndrome_table_type& prediction_table,
+                                const syndrome_table_type& observable_table,
+                                size_t num_observables,
+                                size_t num_shots,
+                                const DECODER_EVAL_CONFIG&);
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
 /*
  * Calls `IMPL::decode` which should take in a `std::vector<GRAPH_COMPONENT_ID>` of
  * detector indices that are flipped, and return a `DECODER_RESULT`
  *
- * This function manages any updates to `DECODER_STATS` during the call
+ * This function manages any updates to `DECODER_STATS` during the call, except for logical errors:
+ * the prediction is copied to `prediction`, and the function returns true if it differs from `obs`.
+ * The errors of a whole batch are counted afterwards by `accumulate_batch_errors`.
  *
  * As clocks do introduce a substantial overhead to runtime (not during
  * `IMPL::decode` but moreso around it), `do_not_clock` can be set to `true`
@@ -74,16 +111,36 @@ struct DECODER_EVAL_CONFIG
  * */
 
 template <class IMPL, class ERROR_CALLBACK> 
-void decode(IMPL&, 
+bool decode(IMPL&, 
             DECODER_STATS&, 
             syndrome_type dets, 
             syndrome_type obs, 
+            syndrome_ref prediction,
             const ERROR_CALLBACK&, 
             const DECODER_EVAL_CONFIG&);
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Batch version of `decode` for decoders with a `decode_batch` function (i.e., `PYMATCHING`).
+ * `detector_table` is indexed [shot][detector] and `observable_table` is indexed [observable][shot]
+ * (as in `stim::FrameSimulator::obs_record`). Errors are counted by `accumulate_batch_errors`.
+ *
+ * The clock covers the whole batch (including trivial shots), so `time_us_by_hamming_weight` is not updated.
+ * */
+
+template <class IMPL>
+void decode_batch(IMPL&,
+                    DECODER_STATS&,
+                    const syndrome_table_type& detector_table,
+                    const syndrome_table_type& observable_table,
+                    size_t num_shots,
+                    const DECODER_EVAL_CONFIG&);
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
 template <class IMPL> 
 DECODER_STATS benchmark_decoder(const stim::Circuit&, 
                                 IMPL&, 
@@ -7,6 +7,7 @@
 #include "decoder/surface_code.h"
 
 #include <chrono>
+#include <iomanip>
 #include <type_traits>
 
 /////////////////////////////////////////////////////
@@ -16,11 +17,12 @@
 template<typename T>
 constexpr bool is_pymatching_v = std::is_same_v<T, PYMATCHING>;
 
-template <class IMPL, class ERROR_CALLBACK> void
+template <class IMPL, class ERROR_CALLBACK> bool
 decode(IMPL& impl, 
         DECODER_STATS& stats,
         syndrome_type detector_flips,
         syndrome_type observable_flips,
+        syndrome_ref prediction,
         const ERROR_CALLBACK& error_callback,
         const DECODER_EVAL_CONFIG& conf)
 {
@@ -33,15 +35,16 @@ decode(IMPL& impl,
     }
 
     size_t hw = detector_list.size();
+    size_t hw_bucket = std::min(hw, stats.trials_by_hamming_weight.size()-1);
 
     stats.trials++;
-    stats.trials_by_hamming_weight[hw]++;
+    stats.trials_by_hamming_weight[hw_bucket]++;
 
     // if there are no detector flips, then exit early:
     if (detector_list.empty())
     {
         stats.trivial_trials++;
-        return;
+        return observable_flips.not_zero();
     }
 
     // start clock:
@@ -59,14 +62,16 @@ decode(IMPL& impl,
 
     uint64_t time_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
     stats.total_time_us += time_us;
-    stats.time_us_by_hamming_weight[hw] += time_us;
+    stats.time_us_by_hamming_weight[hw_bucket] += time_us;
 
-    // check if result is an error:
+    // check if result is an error (a word at a time):
     bool any_mismatch{false};
-    for (size_t i = 0; i < result.flipped_observables.num_bits_padded() && i < observable_flips.num_bits_padded(); i++)
-        any_mismatch |= (result.flipped_observables[i] != observable_flips[i]);
+    const size_t num_words = std::min(result.flipped_observables.num_u64_padded(), observable_flips.num_u64_padded());
+    for (size_t w = 0; w < num_words; w++)
+        any_mismatch |= (result.flipped_observables.u64[w] != observable_flips.u64[w]);
 
-    stats.errors += any_mismatch;
+    for (size_t w = 0; w < num_words && w < prediction.num_u64_padded(); w++)
+        prediction.u64[w] = result.flipped_observables.u64[w];
 
     if (GL_DEBUG_DECODER && any_mismatch)
     {
@@ -104,6 +109,43 @@ decode(IMPL& impl,
             std::cerr << "\n\n";
         }
     }
+
+    return any_mismatch;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+template <class IMPL> void
+decode_batch(IMPL& impl,
+                DECODER_STATS& stats,
+                const syndrome_table_type& detector_table,
+                const syndrome_table_type& observable_table,
+                size_t num_shots,
+                const DECODER_EVAL_CONFIG& conf)
+{
+    const size_t num_observables = impl.get_num_observables();
+    syndrome_table_type prediction_table(num_observables, num_shots);
+
+    std::chrono::steady_clock::time_point start_time, end_time;
+    if (conf.enable_clock)
+        start_time = std::chrono::steady_clock::now();
+
+    impl.decode_batch(detector_table, num_shots, prediction_table);
+
+    if (conf.enable_clock)
+        end_time = std::chrono::steady_clock::now();
+    stats.total_time_us += std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+
+    const size_t trials = accumulate_batch_errors(stats, prediction_table, observable_table, num_observables, num_shots, conf);
+
+    for (size_t s = 0; s < trials; s++)
+    {
+        const size_t hw = detector_table[s].popcnt();
+        stats.trials_by_hamming_weight[std::min(hw, stats.trials_by_hamming_weight.size()-1)]++;
+        stats.trivial_trials += (hw == 0);
+    }
+    stats.trials += trials;
 }
 
 /////////////////////////////////////////////////////
@@ -130,6 +172,8 @@ benchmark_decoder(const stim::Circuit& circuit,
     [[ maybe_unused ]] size_t num_batches{0};
     [[ maybe_unused ]] size_t errors_in_last_epoch{0};
 
+    const size_t num_observables = circuit.count_observables();
+
     DECODER_STATS stats;
     while (num_trials && stats.errors < conf.stop_at_k_errors)
     {
@@ -158,16 +202,40 @@ benchmark_decoder(const stim::Circuit& circuit,
                             std::move(rng));
         sim.do_circuit(circuit);
 
-        auto detector_table = std::move(sim.det_record.storage);
-        auto observable_table = std::move(sim.obs_record);
-
-        // transpose the tables (currently, indices correspond to [detector,shot])
-        detector_table = detector_table.transposed();
-        observable_table = observable_table.transposed();
+        // transpose the detectors (currently, indices correspond to [detector,shot])
+        auto detector_table = sim.det_record.storage.transposed();
 
         size_t errors_before{stats.errors};
-        for (uint64_t s = 0; s < trials_this_batch && stats.errors < conf.stop_at_k_errors; s++)
-            decode(impl, stats, std::move(detector_table[s]), std::move(observable_table[s]), error_callback, conf);
+
+        // decoders with a batch entry point compare against the observables in the simulator's layout.
+        // The batch path has no per-shot debug output, so it is not used when debugging:
+        bool decoded_as_batch{false};
+        if constexpr (is_pymatching_v<IMPL>)
+        {
+            if (!GL_DEBUG_DECODER)
+            {
+                decode_batch(impl, stats, detector_table, sim.obs_record, trials_this_batch, conf);
+                decoded_as_batch = true;
+            }
+        }
+
+        if (!decoded_as_batch)
+        {
+            // predictions are collected per shot, and the errors are counted over the whole batch:
+            auto observable_table = sim.obs_record.transposed();
+            syndrome_table_type prediction_table(trials_this_batch, num_observables);
+
+            uint64_t s{0},
+                     errors_this_batch{0};
+            while (s < trials_this_batch && stats.errors + errors_this_batch < conf.stop_at_k_errors)
+            {
+                errors_this_batch += decode(impl, stats, std::move(detector_table[s]), std::move(observable_table[s]), 
+                                            prediction_table[s], error_callback, conf);
+                s++;
+            }
+
+            accumulate_batch_errors(stats, prediction_table.transposed(), sim.obs_record, num_observables, s, conf);
+        }
         errors_in_last_epoch += stats.errors - errors_before;
 
         rng = std::move(sim.rng);
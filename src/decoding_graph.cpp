@@ -8,44 +8,80 @@
 
 #include <stim/simulators/error_matcher.h>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Helpers shared by the sequential and parallel builders:
+ * */
+
 SC_DECODING_GRAPH*
-read_surface_code_decoding_graph(const stim::DetectorErrorModel& dem)
+_create_sc_decoding_graph_with_vertices(size_t num_detectors, size_t reserve_edges)
 {
-    auto result = io::read_dem_block(dem);
+    // detectors are streamed in after the errors that reference them, so create all
+    // vertices upfront and fill in their data as the declarations are read.
 
     // add `+1` for the boundary index:
-    SC_DECODING_GRAPH* gr = new SC_DECODING_GRAPH{result.detectors.size()+1, result.errors.size()};
-
-    // create vertices for each detector:
-    for (const auto& [id, dd] : result.detectors)
-        gr->add_vertex(static_cast<GRAPH_COMPONENT_ID>(id), dd);
+    SC_DECODING_GRAPH* gr = new SC_DECODING_GRAPH{num_detectors+1, reserve_edges};
+    for (size_t i = 0; i < num_detectors; i++)
+        gr->add_vertex(static_cast<GRAPH_COMPONENT_ID>(i), {});
 
     // add boundary:
-    auto* boundary = gr->add_vertex(result.detectors.size(), {});
+    auto* boundary = gr->add_vertex(num_detectors, {});
     boundary->data.is_boundary = true;
-    
-    // create edges for each error:
-    for (const auto& [dets, ed] : result.errors)
-    {
-        if (dets.size() > 2 || dets.empty())
+    return gr;
+}
+
+void
+_fail_if_not_sc_error(double error_prob, std::span<const int64_t> dets)
+{
+    if (dets.size() <= 2 && !dets.empty())
+        return;
+
+    std::cerr << "error info:"
+            << "\n\terror prob = " << error_prob
+            << "\n\tdetectors =";
+    for (auto d : dets)
+        std::cerr << " " << d;
+
+    std::cerr << "\n";
+        
+    throw std::runtime_error("SC_DECODING_GRAPH: got error with " + std::to_string(dets.size()) + " detectors");
+}
+
+inline double
+_merge_error_probability(double p1, double p2)
+{
+    return p1*(1-p2) + (1-p1)*p2;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+SC_DECODING_GRAPH*
+read_surface_code_decoding_graph(const stim::DetectorErrorModel& dem, size_t num_threads)
+{
+    if (num_threads > 1)
+        return read_surface_code_decoding_graph_parallel(dem, num_threads);
+
+    const size_t num_detectors = dem.count_detectors();
+    SC_DECODING_GRAPH* gr = _create_sc_decoding_graph_with_vertices(num_detectors, dem.count_errors());
+    auto* boundary = gr->get_vertex(num_detectors);
+
+    io::read_dem_block_streaming(dem,
+        [gr] (int64_t id, const DETECTOR_DATA& dd)
         {
-            std::cerr << "error info:"
-                    << "\n\terror prob = " << ed.error_probability
-                    << "\n\tdetectors =";
-            for (auto d : dets)
-                std::cerr << " " << d;
-
-            std::cerr << "\n";
-                
-            throw std::runtime_error("SC_DECODING_GRAPH: got error with " + std::to_string(dets.size()) + " detectors");
-        }
-        else
+            gr->get_vertex(static_cast<GRAPH_COMPONENT_ID>(id))->data = dd;
+        },
+        [gr, boundary] (double error_prob, std::span<const int64_t> dets, std::span<const int64_t> obs)
         {
+            _fail_if_not_sc_error(error_prob, dets);
+
             // if `dets.size() == 2`, then both `boundary`  will be overwritten.
             // otherwise, `boundary` will be overwritten only once.
             std::array<SC_DECODING_GRAPH::VERTEX*, 2> vlist{boundary, boundary};
@@ -55,13 +91,125 @@ read_surface_code_decoding_graph(const stim::DetectorErrorModel& dem)
             auto* e = gr->get_edge_and_fail_if_nonunique(vlist.begin(), vlist.end());
             if (e != nullptr)
             {
-                // update edge probability:
-                double p1 = e->data.error_probability,
-                       p2 = ed.error_probability;
-                e->data.error_probability = p1*(1-p2) + (1-p1)*p2;
+                // update edge probability (the first error's observables are kept):
+                e->data.error_probability = _merge_error_probability(e->data.error_probability, error_prob);
             }
-            gr->add_edge(vlist.begin(), vlist.end(), ed);
+            else
+            {
+                DECODER_ERROR_DATA ed{error_prob};
+                ed.flipped_observables.insert(obs.begin(), obs.end());
+                gr->add_edge(vlist.begin(), vlist.end(), std::move(ed));
+            }
+        });
+
+    return gr;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * The parallel builder works in three phases:
+ *  (1) The DEM is streamed once (this is inherently sequential due to repeat blocks and shifts). 
+ *      Each error becomes a compact record that is routed to a partition by its canonical edge key.
+ *  (2) Each partition is merged on its own thread. Records within a partition are in DEM order, so 
+ *      each edge's probability is folded in exactly the same order as the sequential builder, and 
+ *      the merged probabilities are bit-identical.
+ *  (3) The merged edges are sorted by their first occurrence and added in a single pass. This 
+ *      reproduces the sequential builder's edge (and adjacency) order.
+ * */
+
+SC_DECODING_GRAPH*
+read_surface_code_decoding_graph_parallel(const stim::DetectorErrorModel& dem, size_t num_threads)
+{
+    struct error_record
+    {
+        uint64_t key;  // (min detector << 32) | max detector, the boundary is `num_detectors`
+        uint64_t seq;  // position in the DEM
+        double   error_prob;
+        uint32_t obs_offset;
+        uint32_t obs_count;
+        bool     swapped;  // if true, the detectors were given in descending order
+    };
+
+    const size_t num_detectors = dem.count_detectors();
+    SC_DECODING_GRAPH* gr = _create_sc_decoding_graph_with_vertices(num_detectors, dem.count_errors());
+
+    num_threads = std::max<size_t>(1, num_threads);
+    auto _partition = [num_threads] (uint64_t key) { return ((key * 0x9e3779b97f4a7c15ull) >> 32) % num_threads; };
+
+    // phase 1:
+    std::vector<std::vector<error_record>> partitions(num_threads);
+    for (auto& p : partitions)
+        p.reserve(dem.count_errors() / num_threads + 1);
+    std::vector<int64_t> obs_pool;
+    uint64_t seq{0};
+
+    io::read_dem_block_streaming(dem,
+        [gr] (int64_t id, const DETECTOR_DATA& dd)
+        {
+            gr->get_vertex(static_cast<GRAPH_COMPONENT_ID>(id))->data = dd;
+        },
+        [&] (double error_prob, std::span<const int64_t> dets, std::span<const int64_t> obs)
+        {
+            _fail_if_not_sc_error(error_prob, dets);
+
+            uint64_t d0 = dets[0],
+                     d1 = dets.size() == 2 ? dets[1] : num_detectors;
+            const bool swapped = d0 > d1;
+            if (swapped)
+                std::swap(d0, d1);
+            const uint64_t key = (d0 << 32) | d1;
+
+            partitions[_partition(key)].push_back({key, seq++, error_prob, 
+                                                    static_cast<uint32_t>(obs_pool.size()), 
+                                                    static_cast<uint32_t>(obs.size()),
+                                                    swapped});
+            obs_pool.insert(obs_pool.end(), obs.begin(), obs.end());
+        });
+
+    // phase 2: records are merged in place -- the first record of each edge holds the merged probability
+    std::vector<std::vector<error_record>> merged(num_threads);
+    auto _merge_partition = [&partitions, &merged] (size_t t)
+    {
+        std::unordered_map<uint64_t, size_t> first_idx;
+        first_idx.reserve(partitions[t].size());
+
+        auto& out = merged[t];
+        for (const auto& r : partitions[t])
+        {
+            auto [it, inserted] = first_idx.try_emplace(r.key, out.size());
+            if (inserted)
+                out.push_back(r);
+            else
+                out[it->second].error_prob = _merge_error_probability(out[it->second].error_prob, r.error_prob);
         }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads-1);
+    for (size_t t = 1; t < num_threads; t++)
+        threads.emplace_back(_merge_partition, t);
+    _merge_partition(0);
+    for (auto& th : threads)
+        th.join();
+
+    // phase 3:
+    std::vector<error_record> edges;
+    for (auto& m : merged)
+        edges.insert(edges.end(), m.begin(), m.end());
+    std::sort(edges.begin(), edges.end(), [] (const auto& a, const auto& b) { return a.seq < b.seq; });
+
+    for (const auto& r : edges)
+    {
+        std::array<SC_DECODING_GRAPH::VERTEX*, 2> vlist{gr->get_vertex(r.key >> 32), 
+                                                        gr->get_vertex(r.key & 0xffff'ffffull)};
+        if (r.swapped)
+            std::swap(vlist[0], vlist[1]);
+
+        DECODER_ERROR_DATA ed{r.error_prob};
+        ed.flipped_observables.insert(obs_pool.begin() + r.obs_offset, obs_pool.begin() + r.obs_offset + r.obs_count);
+        gr->add_edge(vlist.begin(), vlist.end(), std::move(ed));
     }
 
     return gr;
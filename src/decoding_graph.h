@@ -33,6 +33,11 @@ struct DECODER_ERROR_DATA
 
     double                      error_probability;
     quantized_weight_type       quantized_weight;
+
+    // bitmask of `flipped_observables` < 64 (set by `compute_all_edge_observable_masks`). This is
+    // next to `quantized_weight` so that searches read both from the same cache line.
+    uint64_t                    observable_mask{0};
+
     std::unordered_set<int64_t> flipped_observables;
 };
 
@@ -46,7 +51,14 @@ template <size_t COLORABILITY=2> using DG_TYPE = HYPERGRAPH<DETECTOR_DATA, DECOD
 
 using SC_DECODING_GRAPH = DG_TYPE<2>;
 
-SC_DECODING_GRAPH* read_surface_code_decoding_graph(const stim::DetectorErrorModel& dem);
+/*
+ * Duplicate errors on the same edge are merged as independent mechanisms: p1*(1-p2) + (1-p1)*p2.
+ * If `num_threads > 1`, this calls `read_surface_code_decoding_graph_parallel`, which produces
+ * a graph identical to the sequential builder (same edge order and bit-identical probabilities).
+ * */
+
+SC_DECODING_GRAPH* read_surface_code_decoding_graph(const stim::DetectorErrorModel& dem, size_t num_threads=1);
+SC_DECODING_GRAPH* read_surface_code_decoding_graph_parallel(const stim::DetectorErrorModel& dem, size_t num_threads);
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
@@ -62,6 +74,20 @@ quantize_all_edge_weights(DG_PTR& dg)
     }
 }
 
+template <class DG_PTR> void
+compute_all_edge_observable_masks(DG_PTR& dg)
+{
+    for (auto* e : dg->get_edges())
+    {
+        e->data.observable_mask = 0;
+        for (auto obs_id : e->data.flipped_observables)
+        {
+            if (obs_id < 64)
+                e->data.observable_mask |= uint64_t{1} << obs_id;
+        }
+    }
+}
+
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
@@ -1,5 +1,9 @@
 // these are just global variable initializations:
 
+#include <string>
+
 bool GL_DEBUG_DECODER{false};
 
 bool GL_EPR_PYMATCHING_VERBOSE{false};
+
+std::string GL_DG_CACHE_DIR{};
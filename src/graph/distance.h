@@ -7,7 +7,9 @@
 #define GRAPH_DISTANCE_h
 
 #include "hypergraph.h"
+#include "graph/priority_queue.h"
 
+#include <limits>
 #include <vector>
 
 namespace graph
@@ -23,8 +25,96 @@ struct DIJKSTRA_RESULT
     std::vector<GRAPH_COMPONENT_ID> prev;
 };
 
+/*
+ * Parity function for searches that do not track observable parity.
+ * */
+
+struct NO_PARITY
+{
+    template <class EDGE_TYPE> uint64_t operator()(const EDGE_TYPE*) const { return 0; }
+};
+
+/*
+ * Reusable buffers for `dijkstra`. Entries are only valid if their epoch matches the current
+ * search, so starting a new search is O(1) instead of O(|V|), and the cost of a search is
+ * proportional to the number of vertices it touches.
+ *
+ * Results are read from the workspace and are invalidated by the next call to `run`.
+ *
+ * `run_with_parity` also labels each reached vertex with the XOR of `PARITY_FUNCTION(e)` (a 64-bit
+ * observable mask) along its path from the source, so the observables flipped between two vertices
+ * of the same tree are `parity(u) ^ parity(v)`, without walking the path.
+ *
+ * `QUEUE_TYPE` is a queue from `priority_queue.h`. For integral weights (i.e., quantized
+ * weights), `RADIX_HEAP_QUEUE` can be used instead of the default binary heap.
+ *
+ * Precondition: vertex id's are contiguous and start from 0.
+ * */
+
+template <class WEIGHT_TYPE, class QUEUE_TYPE=BINARY_HEAP_QUEUE<WEIGHT_TYPE>>
+class DIJKSTRA_WORKSPACE
+{
+public:
+    using parity_type = uint64_t;
+
+    constexpr static WEIGHT_TYPE INF{std::numeric_limits<WEIGHT_TYPE>::max()};
+private:
+    std::vector<WEIGHT_TYPE>        dist_;
+    std::vector<GRAPH_COMPONENT_ID> prev_;
+    std::vector<parity_type>        parity_;
+    std::vector<uint32_t>           visit_epoch_;
+    std::vector<uint32_t>           target_epoch_;
+    QUEUE_TYPE                      queue_;
+
+    uint32_t epoch_{0};
+public:
+    DIJKSTRA_WORKSPACE(size_t num_vertices=0);
+
+    // grows the buffers if the graph has more than `num_vertices` vertices.
+    void reserve(size_t num_vertices);
+
+    /*
+     * Runs a search from `src`. If `terminate_early` is true, the search stops once
+     * all vertices in [et_begin, et_end) are settled.
+     * */
+    template <class GRAPH_TYPE, 
+                class WEIGHT_FUNCTION, 
+                class EARLY_TERM_ITER=std::vector<GRAPH_COMPONENT_ID>::const_iterator>
+    void run(const GRAPH_TYPE&,
+                GRAPH_COMPONENT_ID src,
+                const WEIGHT_FUNCTION&,
+                bool terminate_early=false,
+                EARLY_TERM_ITER et_begin={},
+                EARLY_TERM_ITER et_end={});
+
+    template <class GRAPH_TYPE, 
+                class WEIGHT_FUNCTION, 
+                class PARITY_FUNCTION,
+                class EARLY_TERM_ITER=std::vector<GRAPH_COMPONENT_ID>::const_iterator>
+    void run_with_parity(const GRAPH_TYPE&,
+                            GRAPH_COMPONENT_ID src,
+                            const WEIGHT_FUNCTION&,
+                            const PARITY_FUNCTION&,
+                            bool terminate_early=false,
+                            EARLY_TERM_ITER et_begin={},
+                            EARLY_TERM_ITER et_end={});
+
+    bool               is_reached(GRAPH_COMPONENT_ID id) const { return visit_epoch_[id] == epoch_; }
+    WEIGHT_TYPE        dist(GRAPH_COMPONENT_ID id) const { return is_reached(id) ? dist_[id] : INF; }
+    GRAPH_COMPONENT_ID prev(GRAPH_COMPONENT_ID id) const { return prev_[id]; }
+    parity_type        parity(GRAPH_COMPONENT_ID id) const { return parity_[id]; }
+
+    // same as `dijkstra_path`, but reads from the workspace:
+    std::vector<GRAPH_COMPONENT_ID> path(GRAPH_COMPONENT_ID src, GRAPH_COMPONENT_ID dst, bool reverse_ok=false) const;
+private:
+    void next_epoch();
+};
+
 /*
  * Precondition: `dijkstra` assumes that the vertex id's are contiguous and start from 0.
+ *
+ * This allocates a new workspace per call. Use `DIJKSTRA_WORKSPACE` directly when running
+ * many searches over the same graph.
  * */
 
 template <class WEIGHT_TYPE,
@@ -3,8 +3,9 @@
  *  date:   12 October 2025
  */
 
+#include <algorithm>
 #include <limits>
-#include <queue>
+#include <type_traits>
 
 namespace graph
 {
@@ -12,50 +13,93 @@ namespace graph
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
-template <class W, class GRAPH_TYPE, class WEIGHT_FUNCTION, class EARLY_TERM_ITER> DIJKSTRA_RESULT<W>
-dijkstra(const GRAPH_TYPE& gr,
-        GRAPH_COMPONENT_ID src,
-        const WEIGHT_FUNCTION& wf,
-        bool terminate_early,
-        EARLY_TERM_ITER et_begin,
-        EARLY_TERM_ITER et_end)
+#define TEMPL_PARAMS    template <class W, class QUEUE_TYPE>
+#define TEMPL_CLASS     DIJKSTRA_WORKSPACE<W, QUEUE_TYPE>
+
+TEMPL_PARAMS
+TEMPL_CLASS::DIJKSTRA_WORKSPACE(size_t num_vertices)
 {
-    constexpr int64_t UNDEFINED{-19243987};  // some random number -- unlikely collision
+    reserve(num_vertices);
+}
 
-    std::vector<W> dist(gr.get_vertices().size(), std::numeric_limits<W>::max());
-    std::vector<GRAPH_COMPONENT_ID> prev(gr.get_vertices().size(), UNDEFINED);
+TEMPL_PARAMS void
+TEMPL_CLASS::reserve(size_t num_vertices)
+{
+    if (num_vertices <= dist_.size())
+        return;
+
+    dist_.resize(num_vertices);
+    prev_.resize(num_vertices);
+    parity_.resize(num_vertices);
+    visit_epoch_.resize(num_vertices, 0);
+    target_epoch_.resize(num_vertices, 0);
+}
 
-    // initialize priority queue:
-    struct queue_entry
-    {
-        GRAPH_COMPONENT_ID id;
-        W                  dist;
-    };
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
 
-    auto cmp = [] (const queue_entry& a, const queue_entry& b) { return a.dist > b.dist; };
-    std::priority_queue<queue_entry, std::vector<queue_entry>, decltype(cmp)> pq(cmp);
+TEMPL_PARAMS
+template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class EARLY_TERM_ITER> void
+TEMPL_CLASS::run(const GRAPH_TYPE& gr,
+                    GRAPH_COMPONENT_ID src,
+                    const WEIGHT_FUNCTION& wf,
+                    bool terminate_early,
+                    EARLY_TERM_ITER et_begin,
+                    EARLY_TERM_ITER et_end)
+{
+    run_with_parity(gr, src, wf, NO_PARITY{}, terminate_early, et_begin, et_end);
+}
 
-    pq.push({src, 0});
-    dist[src] = 0;
-    prev[src] = src;
+TEMPL_PARAMS
+template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION, class EARLY_TERM_ITER> void
+TEMPL_CLASS::run_with_parity(const GRAPH_TYPE& gr,
+                                GRAPH_COMPONENT_ID src,
+                                const WEIGHT_FUNCTION& wf,
+                                const PARITY_FUNCTION& pf,
+                                bool terminate_early,
+                                EARLY_TERM_ITER et_begin,
+                                EARLY_TERM_ITER et_end)
+{
+    constexpr bool TRACK_PARITY = !std::is_same_v<PARITY_FUNCTION, NO_PARITY>;
 
-    // if `ENABLE_EARLY_TERM` is true, then we terminate once `early_term_set` is empty
-    std::unordered_set<GRAPH_COMPONENT_ID> early_term_set;
-    early_term_set.reserve(16);
+    reserve(gr.get_vertices().size());
+    next_epoch();
+
+    queue_.clear();
+
+    // if `terminate_early` is true, then we terminate once all targets are settled:
+    size_t targets_left{0};
     if (terminate_early)
-        early_term_set.insert(et_begin, et_end);
+    {
+        for (auto it = et_begin; it != et_end; it++)
+        {
+            if (target_epoch_[*it] != epoch_)
+            {
+                target_epoch_[*it] = epoch_;
+                targets_left++;
+            }
+        }
+    }
+
+    queue_.push(src, 0);
+    dist_[src] = 0;
+    prev_[src] = src;
+    parity_[src] = 0;
+    visit_epoch_[src] = epoch_;
 
-    while (!pq.empty() && (!terminate_early || !early_term_set.empty()))
+    while (!queue_.empty() && (!terminate_early || targets_left > 0))
     {
-        auto [v_id, d] = pq.top();
-        pq.pop();
+        auto [v_id, d] = queue_.pop();
 
         // check if `v_id` is up-to-date:
-        if (d > dist[v_id])
+        if (d > dist_[v_id])
             continue;
 
-        if (terminate_early)   
-            early_term_set.erase(v_id);
+        if (terminate_early && target_epoch_[v_id] == epoch_)
+        {
+            target_epoch_[v_id] = 0;
+            targets_left--;
+        }
 
         // otherwise, get the corresponding vertex:
         auto* v = gr.get_vertex(v_id);
@@ -64,16 +108,85 @@ dijkstra(const GRAPH_TYPE& gr,
             GRAPH_COMPONENT_ID w_id = w->id;
 
             W new_dist = d + wf(e);
-            if (new_dist < dist[w_id])
+            if (visit_epoch_[w_id] != epoch_ || new_dist < dist_[w_id])
             {
-                dist[w_id] = new_dist;
-                prev[w_id] = v_id;
-                pq.push({w_id, new_dist});
+                visit_epoch_[w_id] = epoch_;
+                dist_[w_id] = new_dist;
+                prev_[w_id] = v_id;
+                if constexpr (TRACK_PARITY)
+                    parity_[w_id] = parity_[v_id] ^ pf(e);
+                queue_.push(w_id, new_dist);
             }
         }
     }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS std::vector<GRAPH_COMPONENT_ID>
+TEMPL_CLASS::path(GRAPH_COMPONENT_ID src, GRAPH_COMPONENT_ID dst, bool reverse_ok) const
+{
+    std::vector<GRAPH_COMPONENT_ID> p;
+    p.reserve(4);
+
+    GRAPH_COMPONENT_ID curr{dst};
+    while (curr != src)
+    {
+        p.push_back(curr);
+        curr = prev_[curr];
+    }
+    p.push_back(src);
+
+    if (!reverse_ok)
+        std::reverse(p.begin(), p.end());
+
+    return p;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS void
+TEMPL_CLASS::next_epoch()
+{
+    // on wraparound, stale stamps could collide with the new epoch, so clear them:
+    if (++epoch_ == 0)
+    {
+        std::fill(visit_epoch_.begin(), visit_epoch_.end(), 0);
+        std::fill(target_epoch_.begin(), target_epoch_.end(), 0);
+        epoch_ = 1;
+    }
+}
+
+#undef TEMPL_PARAMS
+#undef TEMPL_CLASS
 
-    return DIJKSTRA_RESULT<W>{dist, prev};
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+template <class W, class GRAPH_TYPE, class WEIGHT_FUNCTION, class EARLY_TERM_ITER> DIJKSTRA_RESULT<W>
+dijkstra(const GRAPH_TYPE& gr,
+        GRAPH_COMPONENT_ID src,
+        const WEIGHT_FUNCTION& wf,
+        bool terminate_early,
+        EARLY_TERM_ITER et_begin,
+        EARLY_TERM_ITER et_end)
+{
+    constexpr int64_t UNDEFINED{-19243987};  // some random number -- unlikely collision
+
+    const size_t n = gr.get_vertices().size();
+
+    DIJKSTRA_WORKSPACE<W> ws(n);
+    ws.run(gr, src, wf, terminate_early, et_begin, et_end);
+
+    DIJKSTRA_RESULT<W> result{std::vector<W>(n), std::vector<GRAPH_COMPONENT_ID>(n)};
+    for (size_t i = 0; i < n; i++)
+    {
+        result.dist[i] = ws.dist(i);
+        result.prev[i] = ws.is_reached(i) ? ws.prev(i) : UNDEFINED;
+    }
+    return result;
 }
 
 /////////////////////////////////////////////////////
@@ -0,0 +1,94 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#ifndef GRAPH_DISTANCE_TABLE_h
+#define GRAPH_DISTANCE_TABLE_h
+
+#include "hypergraph.h"
+
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Precomputed shortest-path distances and path parities (XOR of `PARITY_FUNCTION` along
+ * the shortest path) for a static graph.
+ *
+ * If a full `|V| x |V|` table fits in `max_bytes`, it is built. Otherwise, each row is
+ * radius-bounded: a row holds the closest vertices to its source, up to as many entries as
+ * the memory budget allows. Rows listed in `full_rows` (i.e., the boundary) are always complete.
+ *
+ * Rows are built in parallel at construction. `lookup` returns `std::nullopt` if the pair
+ * is outside both rows' radius, in which case the caller should fall back to `dijkstra`.
+ *
+ * Precondition: as with `dijkstra`, vertex id's are contiguous and start from 0.
+ * */
+
+template <class W, class PARITY_TYPE>
+class DISTANCE_TABLE
+{
+public:
+    static_assert(std::is_integral_v<W>, "DISTANCE_TABLE requires integral weights");
+
+    struct entry
+    {
+        GRAPH_COMPONENT_ID target;
+        W                  dist;
+        PARITY_TYPE        parity;
+    };
+
+    struct lookup_result
+    {
+        W           dist;
+        PARITY_TYPE parity;
+    };
+
+    constexpr static W INF{std::numeric_limits<W>::max()};
+private:
+    size_t num_vertices_;
+    bool   is_full_;
+
+    // full table (row-major):
+    std::vector<W>           full_dist_;
+    std::vector<PARITY_TYPE> full_parity_;
+
+    // bounded table: `rows_[u]` is sorted by target. `row_radius_[u]` is the largest distance `r` such
+    // that every vertex within `r` of `u` is in `rows_[u]` (`INF` for complete rows).
+    std::vector<std::vector<entry>> rows_;
+    std::vector<W>                  row_radius_;
+public:
+    template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION>
+    DISTANCE_TABLE(const GRAPH_TYPE&,
+                    const WEIGHT_FUNCTION&,
+                    const PARITY_FUNCTION&,
+                    size_t max_bytes,
+                    size_t num_threads,
+                    const std::vector<GRAPH_COMPONENT_ID>& full_rows={});
+
+    std::optional<lookup_result> lookup(GRAPH_COMPONENT_ID, GRAPH_COMPONENT_ID) const;
+
+    bool   is_full() const { return is_full_; }
+    size_t memory_bytes() const;
+
+    static size_t full_table_bytes(size_t num_vertices) { return num_vertices*num_vertices*(sizeof(W)+sizeof(PARITY_TYPE)); }
+private:
+    std::optional<lookup_result> lookup_row(GRAPH_COMPONENT_ID src, GRAPH_COMPONENT_ID dst) const;
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+}  // namespace graph
+
+#include "distance_table.tpp"
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <queue>
+#include <thread>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#define TEMPL_PARAMS    template <class W, class PARITY_TYPE>
+#define TEMPL_CLASS     DISTANCE_TABLE<W, PARITY_TYPE>
+
+/*
+ * Single-source search used to build a row. Settles at most `max_settled` vertices (in order of distance),
+ * calling `settle_cb(id, dist, parity)` for each, and returns the row radius.
+ * */
+
+template <class W, class PARITY_TYPE, class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION, class SETTLE_CALLBACK> W
+_distance_table_row_search(const GRAPH_TYPE& gr,
+                            GRAPH_COMPONENT_ID src,
+                            const WEIGHT_FUNCTION& wf,
+                            const PARITY_FUNCTION& pf,
+                            size_t max_settled,
+                            std::vector<W>& dist,
+                            std::vector<PARITY_TYPE>& parity,
+                            std::vector<GRAPH_COMPONENT_ID>& touched,
+                            const SETTLE_CALLBACK& settle_cb)
+{
+    constexpr W INF{std::numeric_limits<W>::max()};
+
+    struct queue_entry
+    {
+        GRAPH_COMPONENT_ID id;
+        W                  dist;
+    };
+
+    auto cmp = [] (const queue_entry& a, const queue_entry& b) { return a.dist > b.dist; };
+    std::priority_queue<queue_entry, std::vector<queue_entry>, decltype(cmp)> pq(cmp);
+
+    // reset only the vertices touched by the previous search:
+    for (auto id : touched)
+        dist[id] = INF;
+    touched.clear();
+
+    dist[src] = 0;
+    parity[src] = PARITY_TYPE{};
+    touched.push_back(src);
+    pq.push({src, 0});
+
+    size_t settled{0};
+    while (!pq.empty())
+    {
+        auto [v_id, d] = pq.top();
+        pq.pop();
+
+        if (d > dist[v_id])
+            continue;
+
+        // every unsettled vertex is at least `d` away:
+        if (settled == max_settled)
+            return d-1;
+
+        settle_cb(v_id, d, parity[v_id]);
+        settled++;
+
+        auto* v = gr.get_vertex(v_id);
+        for (const auto& [w, e] : gr.get_adjacency_list(v))
+        {
+            GRAPH_COMPONENT_ID w_id = w->id;
+
+            W new_dist = d + wf(e);
+            if (new_dist < dist[w_id])
+            {
+                if (dist[w_id] == INF)
+                    touched.push_back(w_id);
+                dist[w_id] = new_dist;
+                parity[w_id] = parity[v_id] ^ pf(e);
+                pq.push({w_id, new_dist});
+            }
+        }
+    }
+
+    return INF;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS
+template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION>
+TEMPL_CLASS::DISTANCE_TABLE(const GRAPH_TYPE& gr,
+                            const WEIGHT_FUNCTION& wf,
+                            const PARITY_FUNCTION& pf,
+                            size_t max_bytes,
+                            size_t num_threads,
+                            const std::vector<GRAPH_COMPONENT_ID>& full_rows)
+    :num_vertices_(gr.get_vertices().size()),
+    is_full_(full_table_bytes(gr.get_vertices().size()) <= max_bytes)
+{
+    const size_t n = num_vertices_;
+
+    // compute the number of entries per row for a bounded table:
+    size_t max_entries_per_row{n};
+    if (is_full_)
+    {
+        full_dist_.assign(n*n, INF);
+        full_parity_.assign(n*n, PARITY_TYPE{});
+    }
+    else
+    {
+        const size_t full_row_bytes = full_rows.size() * n * sizeof(entry);
+        const size_t remaining_bytes = (max_bytes > full_row_bytes) ? max_bytes - full_row_bytes : 0;
+        max_entries_per_row = std::max<size_t>(1, remaining_bytes / (n*sizeof(entry)));
+
+        rows_.resize(n);
+        row_radius_.resize(n);
+    }
+
+    std::vector<bool> is_full_row(n, false);
+    for (auto id : full_rows)
+        is_full_row[id] = true;
+
+    std::atomic<size_t> next_row{0};
+    auto _build_rows = [&] ()
+    {
+        std::vector<W> dist(n, INF);
+        std::vector<PARITY_TYPE> parity(n);
+        std::vector<GRAPH_COMPONENT_ID> touched;
+        touched.reserve(n);
+
+        for (size_t u = next_row++; u < n; u = next_row++)
+        {
+            if (is_full_)
+            {
+                _distance_table_row_search<W, PARITY_TYPE>(gr, u, wf, pf, n, dist, parity, touched,
+                        [this, u, n] (GRAPH_COMPONENT_ID v, W d, PARITY_TYPE p)
+                        {
+                            full_dist_[u*n + v] = d;
+                            full_parity_[u*n + v] = p;
+                        });
+            }
+            else
+            {
+                auto& row = rows_[u];
+                const size_t k = is_full_row[u] ? n : max_entries_per_row;
+                row.reserve(k);
+                row_radius_[u] = _distance_table_row_search<W, PARITY_TYPE>(gr, u, wf, pf, k, dist, parity, touched,
+                                        [&row] (GRAPH_COMPONENT_ID v, W d, PARITY_TYPE p)
+                                        {
+                                            row.push_back({v, d, p});
+                                        });
+                std::sort(row.begin(), row.end(), [] (const entry& a, const entry& b) { return a.target < b.target; });
+            }
+        }
+    };
+
+    num_threads = std::max<size_t>(1, num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads-1);
+    for (size_t t = 1; t < num_threads; t++)
+        threads.emplace_back(_build_rows);
+    _build_rows();
+    for (auto& th : threads)
+        th.join();
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS std::optional<typename TEMPL_CLASS::lookup_result>
+TEMPL_CLASS::lookup(GRAPH_COMPONENT_ID u, GRAPH_COMPONENT_ID v) const
+{
+    if (is_full_)
+    {
+        const size_t idx = static_cast<size_t>(u)*num_vertices_ + v;
+        return lookup_result{full_dist_[idx], full_parity_[idx]};
+    }
+
+    // the graph is undirected, so either row can answer the query:
+    auto r = lookup_row(u, v);
+    return r.has_value() ? r : lookup_row(v, u);
+}
+
+TEMPL_PARAMS std::optional<typename TEMPL_CLASS::lookup_result>
+TEMPL_CLASS::lookup_row(GRAPH_COMPONENT_ID src, GRAPH_COMPONENT_ID dst) const
+{
+    const auto& row = rows_[src];
+    auto it = std::lower_bound(row.begin(), row.end(), dst,
+                                [] (const entry& e, GRAPH_COMPONENT_ID id) { return e.target < id; });
+    if (it != row.end() && it->target == dst)
+        return lookup_result{it->dist, it->parity};
+
+    // if the row is complete, then `dst` is unreachable:
+    if (row_radius_[src] == INF)
+        return lookup_result{INF, PARITY_TYPE{}};
+
+    return std::nullopt;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS size_t
+TEMPL_CLASS::memory_bytes() const
+{
+    if (is_full_)
+        return full_table_bytes(num_vertices_);
+
+    size_t bytes = row_radius_.size()*sizeof(W);
+    for (const auto& row : rows_)
+        bytes += row.capacity()*sizeof(entry);
+    return bytes;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#undef TEMPL_PARAMS
+#undef TEMPL_CLASS
+
+}  // namespace graph
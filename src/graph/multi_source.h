@@ -0,0 +1,146 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#ifndef GRAPH_MULTI_SOURCE_h
+#define GRAPH_MULTI_SOURCE_h
+
+#include "hypergraph.h"
+#include "graph/distance.h"
+#include "graph/priority_queue.h"
+
+#include <limits>
+#include <vector>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Grows shortest-path regions from many sources at once, with a single shared queue. There is
+ * one label per (vertex, source) pair that has been reached, so the work is proportional to the
+ * total size of the regions rather than `num_sources * |V|`. Labels are indexed by a dense
+ * `num_sources x |V|` array if it has at most `DENSE_INDEX_MAX_ENTRIES` entries, and by an
+ * open-addressing table otherwise.
+ *
+ * Source `s` only needs targets `t >= first_target[s]`, and only if their distance is less than
+ * `source_radius[s] + target_radius[t]` (i.e., the distances to the boundary, which bound every
+ * pairwise distance through it). A source stops growing once no unsettled target can meet this bound.
+ * Pairs that are not settled have `dist() == INF`.
+ *
+ * `run_with_parity` also labels each (vertex, source) pair with the XOR of `PARITY_FUNCTION(e)` along
+ * its path, so the observables flipped between a source and a target are read in O(1) by `parity`.
+ *
+ * A `barrier` vertex is never expanded through (i.e., the boundary, whose paths are handled by the caller).
+ *
+ * Results are read from the workspace and are invalidated by the next call to `run`.
+ *
+ * Precondition: vertex id's are contiguous and start from 0, and weights are non-negative.
+ * */
+
+template <class WEIGHT_TYPE, class QUEUE_TYPE=BINARY_HEAP_QUEUE<WEIGHT_TYPE>>
+class MULTI_SOURCE_WORKSPACE
+{
+public:
+    using parity_type = uint64_t;
+
+    constexpr static WEIGHT_TYPE INF{std::numeric_limits<WEIGHT_TYPE>::max()};
+    constexpr static GRAPH_COMPONENT_ID NO_BARRIER{-1};
+    constexpr static size_t DENSE_INDEX_MAX_ENTRIES{1 << 22};
+private:
+    struct label
+    {
+        GRAPH_COMPONENT_ID vertex;
+        uint32_t           source;
+        WEIGHT_TYPE        dist;
+        int32_t            prev_label;  // label of the previous vertex on the path (same source)
+        parity_type        parity;
+    };
+
+    std::vector<label>    labels_;
+
+    // dense index from `source * |V| + vertex` to a label:
+    std::vector<int32_t>  dense_label_;
+    std::vector<uint32_t> dense_epoch_;
+    size_t                num_vertices_{0};
+    bool                  use_dense_index_{false};
+
+    // open-addressing table from `vertex * num_sources + source` to a label:
+    std::vector<uint64_t> slot_key_;
+    std::vector<int32_t>  slot_label_;
+    std::vector<uint32_t> slot_epoch_;
+    size_t                num_sources_{0};
+
+    std::vector<int32_t>  target_index_;
+    std::vector<uint32_t> target_epoch_;
+
+    // results, indexed by `source * num_targets + target`:
+    std::vector<int32_t>  result_label_;
+    size_t                num_targets_{0};
+
+    // targets in decreasing order of `target_radius`, and each source's first unsettled entry:
+    std::vector<size_t>   target_order_;
+    std::vector<size_t>   order_ptr_;
+
+    QUEUE_TYPE queue_;
+    uint32_t   epoch_{0};
+public:
+    MULTI_SOURCE_WORKSPACE() =default;
+
+    template <class GRAPH_TYPE, class WEIGHT_FUNCTION>
+    void run(const GRAPH_TYPE&,
+                const WEIGHT_FUNCTION&,
+                const std::vector<GRAPH_COMPONENT_ID>& sources,
+                const std::vector<GRAPH_COMPONENT_ID>& targets,
+                const std::vector<size_t>& first_target,
+                const std::vector<WEIGHT_TYPE>& source_radius,
+                const std::vector<WEIGHT_TYPE>& target_radius,
+                GRAPH_COMPONENT_ID barrier=NO_BARRIER);
+
+    template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION>
+    void run_with_parity(const GRAPH_TYPE&,
+                            const WEIGHT_FUNCTION&,
+                            const PARITY_FUNCTION&,
+                            const std::vector<GRAPH_COMPONENT_ID>& sources,
+                            const std::vector<GRAPH_COMPONENT_ID>& targets,
+                            const std::vector<size_t>& first_target,
+                            const std::vector<WEIGHT_TYPE>& source_radius,
+                            const std::vector<WEIGHT_TYPE>& target_radius,
+                            GRAPH_COMPONENT_ID barrier=NO_BARRIER);
+
+    // distance from `sources[s]` to `targets[t]`, or `INF` if it was not settled:
+    WEIGHT_TYPE dist(size_t s, size_t t) const;
+
+    // path from `targets[t]` back to `sources[s]` (like `dijkstra_path` with `reverse_ok`):
+    std::vector<GRAPH_COMPONENT_ID> path(size_t s, size_t t) const;
+
+    // observables flipped along the path (only set by `run_with_parity`):
+    parity_type parity(size_t s, size_t t) const;
+
+    size_t num_labels() const { return labels_.size(); }
+private:
+    void reserve(size_t num_vertices);
+    void next_epoch();
+
+    // returns the label of `source` at `v`, and creates it (with distance `INF`) if it does not exist:
+    int32_t get_label(GRAPH_COMPONENT_ID v, uint32_t source, bool& created);
+    void    grow_table();
+
+    // returns the largest distance that source `s` still needs to grow to (negative if it is done):
+    int64_t source_bound(size_t s,
+                            const std::vector<size_t>& first_target,
+                            const std::vector<WEIGHT_TYPE>& source_radius,
+                            const std::vector<WEIGHT_TYPE>& target_radius);
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+}  // namespace graph
+
+#include "multi_source.tpp"
+
+#endif
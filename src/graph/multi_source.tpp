@@ -0,0 +1,279 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#define TEMPL_PARAMS    template <class W, class QUEUE_TYPE>
+#define TEMPL_CLASS     MULTI_SOURCE_WORKSPACE<W, QUEUE_TYPE>
+
+TEMPL_PARAMS
+template <class GRAPH_TYPE, class WEIGHT_FUNCTION> void
+TEMPL_CLASS::run(const GRAPH_TYPE& gr,
+                    const WEIGHT_FUNCTION& wf,
+                    const std::vector<GRAPH_COMPONENT_ID>& sources,
+                    const std::vector<GRAPH_COMPONENT_ID>& targets,
+                    const std::vector<size_t>& first_target,
+                    const std::vector<W>& source_radius,
+                    const std::vector<W>& target_radius,
+                    GRAPH_COMPONENT_ID barrier)
+{
+    run_with_parity(gr, wf, NO_PARITY{}, sources, targets, first_target, source_radius, target_radius, barrier);
+}
+
+TEMPL_PARAMS
+template <class GRAPH_TYPE, class WEIGHT_FUNCTION, class PARITY_FUNCTION> void
+TEMPL_CLASS::run_with_parity(const GRAPH_TYPE& gr,
+                                const WEIGHT_FUNCTION& wf,
+                                const PARITY_FUNCTION& pf,
+                                const std::vector<GRAPH_COMPONENT_ID>& sources,
+                                const std::vector<GRAPH_COMPONENT_ID>& targets,
+                                const std::vector<size_t>& first_target,
+                                const std::vector<W>& source_radius,
+                                const std::vector<W>& target_radius,
+                                GRAPH_COMPONENT_ID barrier)
+{
+    constexpr bool TRACK_PARITY = !std::is_same_v<PARITY_FUNCTION, NO_PARITY>;
+
+    reserve(gr.get_vertices().size());
+    next_epoch();
+
+    labels_.clear();
+    queue_.clear();
+
+    num_targets_ = targets.size();
+    result_label_.assign(sources.size() * num_targets_, -1);
+
+    for (size_t t = 0; t < targets.size(); t++)
+    {
+        target_index_[targets[t]] = static_cast<int32_t>(t);
+        target_epoch_[targets[t]] = epoch_;
+    }
+
+    target_order_.resize(targets.size());
+    std::iota(target_order_.begin(), target_order_.end(), 0);
+    std::sort(target_order_.begin(), target_order_.end(),
+                [&target_radius] (size_t x, size_t y) { return target_radius[x] > target_radius[y]; });
+    order_ptr_.assign(sources.size(), 0);
+
+    num_sources_ = sources.size();
+    num_vertices_ = gr.get_vertices().size();
+    use_dense_index_ = (num_sources_*num_vertices_ <= DENSE_INDEX_MAX_ENTRIES);
+    if (use_dense_index_ && dense_label_.size() < num_sources_*num_vertices_)
+    {
+        dense_label_.resize(num_sources_*num_vertices_);
+        dense_epoch_.resize(num_sources_*num_vertices_, 0);
+    }
+    if (!use_dense_index_ && slot_key_.empty())
+        grow_table();
+
+    std::vector<int64_t> bound(sources.size());
+    for (size_t s = 0; s < sources.size(); s++)
+    {
+        bound[s] = source_bound(s, first_target, source_radius, target_radius);
+        if (bound[s] < 0)
+            continue;
+
+        bool created;
+        int32_t l = get_label(sources[s], s, created);
+        labels_[l].dist = 0;
+        queue_.push(l, 0);
+    }
+
+    while (!queue_.empty())
+    {
+        auto [l, d] = queue_.pop();
+
+        // copy out the fields, since `labels_` may be reallocated below:
+        const GRAPH_COMPONENT_ID v_id = labels_[l].vertex;
+        const uint32_t s = labels_[l].source;
+        const parity_type p = labels_[l].parity;
+
+        // check if `l` is up-to-date and its source is still growing:
+        if (d > labels_[l].dist || d > bound[s])
+            continue;
+
+        if (target_epoch_[v_id] == epoch_ && static_cast<size_t>(target_index_[v_id]) >= first_target[s])
+        {
+            result_label_[s*num_targets_ + target_index_[v_id]] = l;
+            bound[s] = source_bound(s, first_target, source_radius, target_radius);
+        }
+
+        if (v_id == barrier)
+            continue;
+
+        auto* v = gr.get_vertex(v_id);
+        for (const auto& [w, e] : gr.get_adjacency_list(v))
+        {
+            W new_dist = d + wf(e);
+            if (new_dist > bound[s])
+                continue;
+
+            bool created;
+            int32_t wl = get_label(w->id, s, created);
+            if (created || new_dist < labels_[wl].dist)
+            {
+                labels_[wl].dist = new_dist;
+                labels_[wl].prev_label = l;
+                if constexpr (TRACK_PARITY)
+                    labels_[wl].parity = p ^ pf(e);
+                queue_.push(wl, new_dist);
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS W
+TEMPL_CLASS::dist(size_t s, size_t t) const
+{
+    int32_t l = result_label_[s*num_targets_ + t];
+    return (l < 0) ? INF : labels_[l].dist;
+}
+
+TEMPL_PARAMS typename TEMPL_CLASS::parity_type
+TEMPL_CLASS::parity(size_t s, size_t t) const
+{
+    int32_t l = result_label_[s*num_targets_ + t];
+    return (l < 0) ? parity_type{0} : labels_[l].parity;
+}
+
+TEMPL_PARAMS std::vector<GRAPH_COMPONENT_ID>
+TEMPL_CLASS::path(size_t s, size_t t) const
+{
+    std::vector<GRAPH_COMPONENT_ID> p;
+    p.reserve(4);
+    for (int32_t l = result_label_[s*num_targets_ + t]; l >= 0; l = labels_[l].prev_label)
+        p.push_back(labels_[l].vertex);
+    return p;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+TEMPL_PARAMS int32_t
+TEMPL_CLASS::get_label(GRAPH_COMPONENT_ID v, uint32_t source, bool& created)
+{
+    if (use_dense_index_)
+    {
+        const size_t k = static_cast<size_t>(source)*num_vertices_ + v;
+        created = (dense_epoch_[k] != epoch_);
+        if (created)
+        {
+            dense_epoch_[k] = epoch_;
+            dense_label_[k] = static_cast<int32_t>(labels_.size());
+            labels_.push_back({v, source, INF, -1, 0});
+        }
+        return dense_label_[k];
+    }
+
+    // keep the load factor at most 1/2:
+    if (2*(labels_.size()+1) > slot_key_.size())
+        grow_table();
+
+    const uint64_t key = static_cast<uint64_t>(v)*num_sources_ + source;
+    const size_t mask = slot_key_.size()-1;
+    for (size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask; ; i = (i+1) & mask)
+    {
+        if (slot_epoch_[i] != epoch_)
+        {
+            slot_epoch_[i] = epoch_;
+            slot_key_[i] = key;
+            slot_label_[i] = static_cast<int32_t>(labels_.size());
+            labels_.push_back({v, source, INF, -1, 0});
+            created = true;
+            return slot_label_[i];
+        }
+
+        if (slot_key_[i] == key)
+        {
+            created = false;
+            return slot_label_[i];
+        }
+    }
+}
+
+TEMPL_PARAMS void
+TEMPL_CLASS::grow_table()
+{
+    const size_t new_size = std::max<size_t>(1024, 2*slot_key_.size());
+    slot_key_.assign(new_size, 0);
+    slot_label_.assign(new_size, -1);
+    slot_epoch_.assign(new_size, 0);
+
+    // reinsert the current labels:
+    const size_t mask = new_size-1;
+    for (size_t l = 0; l < labels_.size(); l++)
+    {
+        const uint64_t key = static_cast<uint64_t>(labels_[l].vertex)*num_sources_ + labels_[l].source;
+        size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (slot_epoch_[i] == epoch_)
+            i = (i+1) & mask;
+        slot_epoch_[i] = epoch_;
+        slot_key_[i] = key;
+        slot_label_[i] = static_cast<int32_t>(l);
+    }
+}
+
+TEMPL_PARAMS int64_t
+TEMPL_CLASS::source_bound(size_t s,
+                            const std::vector<size_t>& first_target,
+                            const std::vector<W>& source_radius,
+                            const std::vector<W>& target_radius)
+{
+    // skip targets that are settled or not needed by `s`:
+    size_t& p = order_ptr_[s];
+    while (p < target_order_.size() 
+            && (target_order_[p] < first_target[s] || result_label_[s*num_targets_ + target_order_[p]] >= 0))
+    {
+        p++;
+    }
+
+    if (p == target_order_.size())
+        return -1;
+
+    // a pair is only needed if its distance is strictly less than the sum of the radii:
+    return static_cast<int64_t>(source_radius[s]) + target_radius[target_order_[p]] - 1;
+}
+
+TEMPL_PARAMS void
+TEMPL_CLASS::reserve(size_t num_vertices)
+{
+    if (num_vertices <= target_index_.size())
+        return;
+
+    target_index_.resize(num_vertices);
+    target_epoch_.resize(num_vertices, 0);
+}
+
+TEMPL_PARAMS void
+TEMPL_CLASS::next_epoch()
+{
+    // on wraparound, stale stamps could collide with the new epoch, so clear them:
+    if (++epoch_ == 0)
+    {
+        std::fill(dense_epoch_.begin(), dense_epoch_.end(), 0);
+        std::fill(slot_epoch_.begin(), slot_epoch_.end(), 0);
+        std::fill(target_epoch_.begin(), target_epoch_.end(), 0);
+        epoch_ = 1;
+    }
+}
+
+#undef TEMPL_PARAMS
+#undef TEMPL_CLASS
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+}  // namespace graph
@@ -0,0 +1,102 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#ifndef GRAPH_PRIORITY_QUEUE_h
+#define GRAPH_PRIORITY_QUEUE_h
+
+#include "hypergraph.h"
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Priority queues for `DIJKSTRA_WORKSPACE`. Both pop the entry with the smallest
+ * distance and support lazy deletion (the caller skips stale entries).
+ *
+ * Interface: `push(id, dist)`, `pop()`, `empty()`, `clear()`.
+ * */
+
+template <class W>
+struct QUEUE_ENTRY
+{
+    GRAPH_COMPONENT_ID id;
+    W                  dist;
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Binary heap. Works for any weight type.
+ * */
+
+template <class W>
+class BINARY_HEAP_QUEUE
+{
+public:
+    using entry = QUEUE_ENTRY<W>;
+private:
+    std::vector<entry> heap_;
+public:
+    void  push(GRAPH_COMPONENT_ID, W);
+    entry pop();
+
+    bool empty() const { return heap_.empty(); }
+    void clear() { heap_.clear(); }
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * Radix heap (Ahuja et al.) for monotone integer keys: every pushed distance must be at
+ * least the last popped distance, which holds for Dijkstra with non-negative weights.
+ *
+ * Bucket `i > 0` holds keys that first differ from the last popped key at bit `i-1`, so
+ * each entry is moved at most `bit width` times over its lifetime, and `pop` is O(1) amortized
+ * plus a scan over the (fixed number of) buckets.
+ * */
+
+template <class W>
+class RADIX_HEAP_QUEUE
+{
+public:
+    static_assert(std::is_integral_v<W>, "RADIX_HEAP_QUEUE requires integral weights");
+
+    using entry = QUEUE_ENTRY<W>;
+    using key_type = std::make_unsigned_t<W>;
+
+    constexpr static size_t NUM_BUCKETS{std::numeric_limits<key_type>::digits + 1};
+private:
+    std::array<std::vector<entry>, NUM_BUCKETS> buckets_;
+
+    key_type last_{0};
+    size_t   size_{0};
+public:
+    void  push(GRAPH_COMPONENT_ID, W);
+    entry pop();
+
+    bool empty() const { return size_ == 0; }
+    void clear();
+private:
+    size_t bucket_index(key_type) const;
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+}  // namespace graph
+
+#include "priority_queue.tpp"
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#include <algorithm>
+#include <bit>
+
+namespace graph
+{
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+template <class W> void
+BINARY_HEAP_QUEUE<W>::push(GRAPH_COMPONENT_ID id, W dist)
+{
+    auto cmp = [] (const entry& a, const entry& b) { return a.dist > b.dist; };
+    heap_.push_back({id, dist});
+    std::push_heap(heap_.begin(), heap_.end(), cmp);
+}
+
+template <class W> typename BINARY_HEAP_QUEUE<W>::entry
+BINARY_HEAP_QUEUE<W>::pop()
+{
+    auto cmp = [] (const entry& a, const entry& b) { return a.dist > b.dist; };
+    std::pop_heap(heap_.begin(), heap_.end(), cmp);
+    entry e = heap_.back();
+    heap_.pop_back();
+    return e;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+template <class W> void
+RADIX_HEAP_QUEUE<W>::push(GRAPH_COMPONENT_ID id, W dist)
+{
+    buckets_[bucket_index(static_cast<key_type>(dist))].push_back({id, dist});
+    size_++;
+}
+
+template <class W> typename RADIX_HEAP_QUEUE<W>::entry
+RADIX_HEAP_QUEUE<W>::pop()
+{
+    // if bucket 0 is empty, find the first non-empty bucket, set `last_` to its minimum,
+    // and redistribute it. All of its entries move to strictly lower buckets.
+    if (buckets_[0].empty())
+    {
+        size_t i{1};
+        while (buckets_[i].empty())
+            i++;
+
+        auto& b = buckets_[i];
+        auto min_it = std::min_element(b.begin(), b.end(), 
+                                        [] (const entry& x, const entry& y) { return x.dist < y.dist; });
+        last_ = static_cast<key_type>(min_it->dist);
+
+        for (const auto& e : b)
+            buckets_[bucket_index(static_cast<key_type>(e.dist))].push_back(e);
+        b.clear();
+    }
+
+    entry e = buckets_[0].back();
+    buckets_[0].pop_back();
+    size_--;
+    return e;
+}
+
+template <class W> void
+RADIX_HEAP_QUEUE<W>::clear()
+{
+    for (auto& b : buckets_)
+        b.clear();
+    last_ = 0;
+    size_ = 0;
+}
+
+template <class W> size_t
+RADIX_HEAP_QUEUE<W>::bucket_index(key_type k) const
+{
+    return (k == last_) ? 0 : std::bit_width(static_cast<key_type>(k ^ last_));
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+}  // namespace graph
@@ -51,7 +51,18 @@ protected:
     std::vector<VERTEX*> vertices_;
     std::vector<EDGE*>   edges_;
 
+    /*
+     * Vertex lookup by id. While ids are dense (non-negative and less than 
+     * `max(DENSE_MIN_CAPACITY, DENSE_GROWTH_FACTOR*|V|)`), lookups index into `vertex_id_table_`. 
+     * Once an id breaks this, the graph permanently falls back to `vertex_id_map_`.
+     * */
+    constexpr static size_t DENSE_MIN_CAPACITY{1024};
+    constexpr static size_t DENSE_GROWTH_FACTOR{2};
+
+    bool                                 dense_ids_{true};
+    std::vector<VERTEX*>                 vertex_id_table_;
     std::unordered_map<id_type, VERTEX*> vertex_id_map_;
+
     std::unordered_map<VERTEX*, adjacency_list> adjacency_;
 public:
     HYPERGRAPH(size_t reserve_vertices=1024, size_t reserve_edges=4096);
@@ -61,6 +72,7 @@ public:
     template <class ITER> EDGE* add_edge(ITER v_begin, ITER v_end, EDGE_DATA_TYPE);
 
     VERTEX* get_vertex(id_type) const;
+    bool    has_dense_ids() const { return dense_ids_; }
     void remove_vertex(VERTEX*);
 
     EDGE* get_edge_and_fail_if_nonunique(VERTEX*, VERTEX*);
@@ -74,6 +86,8 @@ public:
     const adjacency_list&       get_adjacency_list(VERTEX* v) const { return adjacency_.at(v); }
 
     constexpr static size_t max_order() { return MAX_ORDER; }
+private:
+    void switch_to_sparse_ids();
 };
 
 /////////////////////////////////////////////////////
@@ -17,6 +17,7 @@ TEMPL_PARAMS
 TEMPL_CLASS::HYPERGRAPH(size_t reserve_vertices, size_t reserve_edges)
 {
     vertices_.reserve(reserve_vertices);
+    vertex_id_table_.reserve(reserve_vertices);
     edges_.reserve(reserve_edges);
 }
 
@@ -35,12 +36,28 @@ TEMPL_CLASS::~HYPERGRAPH()
 TEMPL_PARAMS typename TEMPL_CLASS::VERTEX*
 TEMPL_CLASS::add_vertex(id_type id, VERTEX_DATA_TYPE data)
 {
-    if (vertex_id_map_.find(id) != vertex_id_map_.end())
+    if (get_vertex(id) != nullptr)
         throw std::runtime_error("vertex already exists");
 
+    if (dense_ids_)
+    {
+        const size_t cap = std::max(DENSE_MIN_CAPACITY, DENSE_GROWTH_FACTOR*(vertices_.size()+1));
+        if (id < 0 || static_cast<size_t>(id) >= cap)
+            switch_to_sparse_ids();
+    }
+
     VERTEX* v = new VERTEX{id, data};
     vertices_.push_back(v);
-    vertex_id_map_[id] = v;
+    if (dense_ids_)
+    {
+        if (static_cast<size_t>(id) >= vertex_id_table_.size())
+            vertex_id_table_.resize(std::max<size_t>(id+1, 2*vertex_id_table_.size()), nullptr);
+        vertex_id_table_[id] = v;
+    }
+    else
+    {
+        vertex_id_map_[id] = v;
+    }
     return v;
 }
 
@@ -93,10 +110,25 @@ TEMPL_CLASS::add_edge(ITER v_begin, ITER v_end, EDGE_DATA_TYPE data)
 TEMPL_PARAMS typename TEMPL_CLASS::VERTEX*
 TEMPL_CLASS::get_vertex(id_type id) const
 {
+    if (dense_ids_)
+        return (static_cast<size_t>(id) < vertex_id_table_.size()) ? vertex_id_table_[id] : nullptr;
+
     auto it = vertex_id_map_.find(id);
     return it == vertex_id_map_.end() ? nullptr : it->second;
 }
 
+TEMPL_PARAMS void
+TEMPL_CLASS::switch_to_sparse_ids()
+{
+    vertex_id_map_.reserve(vertices_.size());
+    for (auto* v : vertices_)
+        vertex_id_map_[v->id] = v;
+
+    dense_ids_ = false;
+    vertex_id_table_.clear();
+    vertex_id_table_.shrink_to_fit();
+}
+
 ////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////
 
@@ -133,7 +165,10 @@ TEMPL_CLASS::remove_vertex(VERTEX* v)
     }
 
     // remove the vertex from the incidence map
-    vertex_id_map_.erase(v->id);
+    if (dense_ids_)
+        vertex_id_table_[v->id] = nullptr;
+    else
+        vertex_id_map_.erase(v->id);
     adjacency_.erase(v);
     delete v;
 }
@@ -10,6 +10,9 @@
 
 #include <stim/dem/detector_error_model.h>
 
+#include <span>
+#include <vector>
+
 namespace io
 {
 
@@ -45,14 +48,44 @@ struct DEM_READ_RESULT
 
 DEM_READ_RESULT read_dem_block(const stim::DetectorErrorModel& dem);
 
-void read_dem_block_helper(const stim::DetectorErrorModel& dem, DEM_READ_RESULT&, DEM_BLOCK_INFO&);
+DETECTOR_DATA read_detector_data(const stim::DemInstruction&, const DEM_BLOCK_INFO& info);
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+/*
+ * Streaming version of `read_dem_block`. Nothing is materialized: 
+ *
+ *      `DETECTOR_CALLBACK` is called as `(int64_t id, const DETECTOR_DATA&)` for each declared detector.
+ *      `ERROR_CALLBACK` is called as `(double error_prob, std::span<const int64_t> detectors, 
+ *                                          std::span<const int64_t> observables)` 
+ *          for each component of each error (components are separated by `^`). 
+ *
+ * The spans point into buffers owned by the reader, and are only valid during the call. Errors
+ * with negligible probability (< 1e-18) are skipped.
+ * */
+
+struct DEM_STREAM_BUFFERS
+{
+    std::vector<int64_t> detectors;
+    std::vector<int64_t> observables;
+};
+
+template <class DETECTOR_CALLBACK, class ERROR_CALLBACK> void
+read_dem_block_streaming(const stim::DetectorErrorModel&, const DETECTOR_CALLBACK&, const ERROR_CALLBACK&);
 
-std::vector<DEM_READ_RESULT::detector_type> read_detector_decl(const stim::DemInstruction&, DEM_BLOCK_INFO& info);
-std::vector<DEM_READ_RESULT::error_type>    read_dem_error(const stim::DemInstruction&, DEM_BLOCK_INFO& info);
+template <class DETECTOR_CALLBACK, class ERROR_CALLBACK> void
+read_dem_block_streaming_helper(const stim::DetectorErrorModel&, 
+                                    DEM_BLOCK_INFO&,
+                                    DEM_STREAM_BUFFERS&,
+                                    const DETECTOR_CALLBACK&, 
+                                    const ERROR_CALLBACK&);
 
 ////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////
 
 }   // namespace io
 
+#include "io/dem.tpp"
+
 #endif
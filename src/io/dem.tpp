@@ -0,0 +1,81 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+namespace io
+{
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+template <class DETECTOR_CALLBACK, class ERROR_CALLBACK> void
+read_dem_block_streaming(const stim::DetectorErrorModel& dem,
+                            const DETECTOR_CALLBACK& detector_cb,
+                            const ERROR_CALLBACK& error_cb)
+{
+    DEM_BLOCK_INFO info;
+    DEM_STREAM_BUFFERS buf;
+    buf.detectors.reserve(8);
+    buf.observables.reserve(8);
+    read_dem_block_streaming_helper(dem, info, buf, detector_cb, error_cb);
+}
+
+template <class DETECTOR_CALLBACK, class ERROR_CALLBACK> void
+read_dem_block_streaming_helper(const stim::DetectorErrorModel& dem,
+                                    DEM_BLOCK_INFO& info,
+                                    DEM_STREAM_BUFFERS& buf,
+                                    const DETECTOR_CALLBACK& detector_cb,
+                                    const ERROR_CALLBACK& error_cb)
+{
+    for (const auto& inst : dem.instructions)
+    {
+        if (inst.type == stim::DemInstructionType::DEM_ERROR)
+        {
+            const double error_prob = inst.arg_data[0];
+            if (error_prob < 1e-18)
+                continue;
+
+            inst.for_separated_targets(
+                [&buf, &info, &error_cb, error_prob] (std::span<const stim::DemTarget> tg)
+                {
+                    buf.detectors.clear();
+                    buf.observables.clear();
+                    for (const auto& t : tg)
+                    {
+                        if (t.is_observable_id())
+                            buf.observables.push_back(t.val());
+                        else
+                            buf.detectors.push_back(t.val() + info.id_shift);
+                    }
+                    error_cb(error_prob,
+                            std::span<const int64_t>{buf.detectors},
+                            std::span<const int64_t>{buf.observables});
+                });
+        }
+        else if (inst.type == stim::DemInstructionType::DEM_DETECTOR)
+        {
+            const DETECTOR_DATA data = read_detector_data(inst, info);
+            for (const auto& t : inst.target_data)
+                detector_cb(static_cast<int64_t>(t.val() + info.id_shift), data);
+        }
+        else if (inst.type == stim::DemInstructionType::DEM_REPEAT_BLOCK)
+        {
+            const auto& b = inst.repeat_block_body(dem);
+            size_t num_reps = inst.repeat_block_rep_count();
+            for (size_t i = 0; i < num_reps; ++i)
+                read_dem_block_streaming_helper(b, info, buf, detector_cb, error_cb);
+        }
+        else if (inst.type == stim::DemInstructionType::DEM_SHIFT_DETECTORS)
+        {
+            for (size_t i = 0; i < inst.arg_data.size(); ++i)
+                info.coord_shift[i] += inst.arg_data[i];
+            info.id_shift += inst.target_data[0].val();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+}   // namespace io
@@ -0,0 +1,414 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#include "io/dg_cache.h"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+
+namespace io
+{
+
+static_assert(sizeof(DG_CACHE_HEADER) == 48 && std::is_trivially_copyable_v<DG_CACHE_HEADER>);
+static_assert(sizeof(DG_CACHE_VERTEX) == 16 && std::is_trivially_copyable_v<DG_CACHE_VERTEX>);
+static_assert(sizeof(DG_CACHE_EDGE) == 32 && std::is_trivially_copyable_v<DG_CACHE_EDGE>);
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+DG_CACHE_FILE::DG_CACHE_FILE(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return;
+
+    const size_t size = static_cast<size_t>(in.tellg());
+    if (size < sizeof(DG_CACHE_HEADER))
+        return;
+
+    // read the whole file at once, into 8-byte words so every section is aligned:
+    std::vector<uint64_t> data((size+7) / 8);
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(data.data()), size))
+        return;
+
+    data_ = std::move(data);
+    size_ = size;
+}
+
+bool
+DG_CACHE_FILE::is_valid(DG_CACHE_KIND kind, uint64_t key) const
+{
+    if (!is_open())
+        return false;
+
+    const auto& h = header();
+    return h.magic == DG_CACHE_MAGIC
+            && h.version == DG_CACHE_VERSION
+            && h.kind == static_cast<uint32_t>(kind)
+            && h.key == key
+            && expected_file_size() == size_;
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+std::span<const DG_CACHE_VERTEX>
+DG_CACHE_FILE::vertices() const
+{
+    return {section_at<DG_CACHE_VERTEX>(vertex_section_offset()), header().num_vertices};
+}
+
+std::span<const DG_CACHE_EDGE>
+DG_CACHE_FILE::edges() const
+{
+    return {section_at<DG_CACHE_EDGE>(edge_section_offset()), header().num_edges};
+}
+
+std::span<const uint64_t>
+DG_CACHE_FILE::observable_mask(size_t edge_idx) const
+{
+    const size_t w = header().obs_words;
+    return {section_at<uint64_t>(obs_section_offset()) + edge_idx*w, w};
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+size_t
+DG_CACHE_FILE::vertex_section_offset() const
+{
+    return sizeof(DG_CACHE_HEADER);
+}
+
+size_t
+DG_CACHE_FILE::edge_section_offset() const
+{
+    return vertex_section_offset() + header().num_vertices*sizeof(DG_CACHE_VERTEX);
+}
+
+size_t
+DG_CACHE_FILE::obs_section_offset() const
+{
+    return edge_section_offset() + header().num_edges*sizeof(DG_CACHE_EDGE);
+}
+
+size_t
+DG_CACHE_FILE::expected_file_size() const
+{
+    return obs_section_offset() + header().num_edges*header().obs_words*sizeof(uint64_t);
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+constexpr uint64_t FNV_OFFSET_BASIS{0xcbf29ce484222325};
+constexpr uint64_t FNV_PRIME{0x100000001b3};
+
+template <class T> void
+_fnv1a_update(uint64_t& h, const T& x)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&x);
+    for (size_t i = 0; i < sizeof(T); i++)
+        h = (h ^ bytes[i]) * FNV_PRIME;
+}
+
+uint64_t
+dg_cache_key(const stim::Circuit& circuit, const stim::DemOptions& opts, DG_CACHE_KIND kind)
+{
+    uint64_t h{FNV_OFFSET_BASIS};
+    for (char c : circuit.str())
+        _fnv1a_update(h, c);
+
+    _fnv1a_update(h, opts.decompose_errors);
+    _fnv1a_update(h, opts.flatten_loops);
+    _fnv1a_update(h, opts.allow_gauge_detectors);
+    _fnv1a_update(h, opts.approximate_disjoint_errors_threshold);
+    _fnv1a_update(h, opts.ignore_decomposition_failures);
+    _fnv1a_update(h, opts.block_decomposition_from_introducing_remnant_edges);
+
+    _fnv1a_update(h, DG_CACHE_VERSION);
+    _fnv1a_update(h, kind);
+    return h;
+}
+
+std::string
+dg_cache_path(DG_CACHE_KIND kind, uint64_t key)
+{
+    std::stringstream strm;
+    strm << GL_DG_CACHE_DIR << "/"
+        << (kind == DG_CACHE_KIND::SC_DECODING_GRAPH ? "sc_dg_" : "pym_ug_")
+        << std::hex << std::setw(16) << std::setfill('0') << key
+        << ".qdg";
+    return strm.str();
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+/*
+ * Writes the full file. `obs_masks` has `obs_words` entries per edge.
+ * */
+
+void
+_write_cache_file(DG_CACHE_KIND kind,
+                    uint64_t key,
+                    const std::vector<DG_CACHE_VERTEX>& vertices,
+                    const std::vector<DG_CACHE_EDGE>& edges,
+                    const std::vector<uint64_t>& obs_masks,
+                    size_t num_observables,
+                    uint32_t obs_words)
+{
+    const size_t n = vertices.size();
+    for (const auto& e : edges)
+    {
+        if (e.src < 0 || static_cast<size_t>(e.src) >= n || e.dst < 0 || static_cast<size_t>(e.dst) >= n)
+            throw std::runtime_error("DG_CACHE: vertex ids must be contiguous and start from 0");
+    }
+
+    DG_CACHE_HEADER h
+    {
+        DG_CACHE_MAGIC,
+        DG_CACHE_VERSION,
+        static_cast<uint32_t>(kind),
+        obs_words,
+        key,
+        n,
+        edges.size(),
+        num_observables
+    };
+
+    // the cache is optional, so failing to store it is only a warning:
+    std::error_code ec;
+    std::filesystem::create_directories(GL_DG_CACHE_DIR, ec);
+    if (ec)
+    {
+        std::cerr << "DG_CACHE: could not create " << GL_DG_CACHE_DIR << ": " << ec.message() << "\n";
+        return;
+    }
+
+    // write to a temporary file first, then rename -- this is atomic, so readers see either
+    // the old file or the complete new file:
+    const std::string path = dg_cache_path(kind, key);
+    const std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+
+    std::ofstream out(tmp_path, std::ios::binary);
+    if (!out.is_open())
+    {
+        std::cerr << "DG_CACHE: could not open " << tmp_path << " for writing\n";
+        return;
+    }
+
+    auto _write = [&out] (const auto* data, size_t count)
+                    {
+                        out.write(reinterpret_cast<const char*>(data), count*sizeof(*data));
+                    };
+    _write(&h, 1);
+    _write(vertices.data(), vertices.size());
+    _write(edges.data(), edges.size());
+    _write(obs_masks.data(), obs_masks.size());
+    out.close();
+
+    if (!out)
+    {
+        std::cerr << "DG_CACHE: could not write " << tmp_path << "\n";
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec)
+    {
+        std::cerr << "DG_CACHE: could not rename " << tmp_path << " to " << path << ": " << ec.message() << "\n";
+        std::filesystem::remove(tmp_path, ec);
+    }
+}
+
+uint32_t
+_obs_words(size_t num_observables)
+{
+    return std::max<size_t>(1, (num_observables+63) / 64);
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+SC_DECODING_GRAPH*
+load_sc_decoding_graph(uint64_t key)
+{
+    if (GL_DG_CACHE_DIR.empty())
+        return nullptr;
+
+    DG_CACHE_FILE f(dg_cache_path(DG_CACHE_KIND::SC_DECODING_GRAPH, key));
+    if (!f.is_valid(DG_CACHE_KIND::SC_DECODING_GRAPH, key))
+        return nullptr;
+
+    auto vertices = f.vertices();
+    auto edges = f.edges();
+    SC_DECODING_GRAPH* gr = new SC_DECODING_GRAPH{vertices.size(), edges.size()};
+
+    for (const auto& v : vertices)
+    {
+        DETECTOR_DATA dd
+        {
+            v.base_detector_id,
+            v.round_id,
+            static_cast<DETECTOR_DATA::COLOR>(v.color),
+            v.is_flag > 0,
+            v.is_boundary > 0
+        };
+        gr->add_vertex(v.id, dd);
+    }
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        const auto& e = edges[i];
+        DECODER_ERROR_DATA ed{e.error_probability, e.quantized_weight};
+
+        auto mask = f.observable_mask(i);
+        for (size_t w = 0; w < mask.size(); w++)
+        {
+            for (uint64_t x = mask[w]; x; x &= x-1)
+                ed.flipped_observables.insert(64*w + __builtin_ctzll(x));
+        }
+
+        std::array<SC_DECODING_GRAPH::VERTEX*, 2> vlist{gr->get_vertex(e.src), gr->get_vertex(e.dst)};
+        gr->add_edge(vlist.begin(), vlist.end(), std::move(ed));
+    }
+
+    return gr;
+}
+
+void
+store_sc_decoding_graph(uint64_t key, const SC_DECODING_GRAPH& gr, size_t num_observables)
+{
+    if (GL_DG_CACHE_DIR.empty())
+        return;
+
+    const uint32_t obs_words = _obs_words(num_observables);
+
+    std::vector<DG_CACHE_VERTEX> vertices;
+    vertices.reserve(gr.get_vertices().size());
+    for (const auto* v : gr.get_vertices())
+    {
+        vertices.push_back(
+        {
+            v->id,
+            v->data.base_detector_id,
+            v->data.round_id,
+            static_cast<uint8_t>(v->data.color),
+            static_cast<uint8_t>(v->data.is_flag),
+            static_cast<uint8_t>(v->data.is_boundary)
+        });
+    }
+
+    std::vector<DG_CACHE_EDGE> edges;
+    std::vector<uint64_t> obs_masks(gr.get_edges().size() * obs_words, 0);
+    edges.reserve(gr.get_edges().size());
+    for (const auto* e : gr.get_edges())
+    {
+        uint64_t* mask = obs_masks.data() + edges.size()*obs_words;
+        for (auto obs_id : e->data.flipped_observables)
+            mask[obs_id / 64] |= 1ull << (obs_id % 64);
+
+        DG_CACHE_EDGE ce{};
+        ce.src = e->vertices[0]->id;
+        ce.dst = e->vertices[1]->id;
+        ce.error_probability = e->data.error_probability;
+        ce.quantized_weight = e->data.quantized_weight;
+        edges.push_back(ce);
+    }
+
+    _write_cache_file(DG_CACHE_KIND::SC_DECODING_GRAPH, key, vertices, edges, obs_masks, num_observables, obs_words);
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+std::optional<pm::UserGraph>
+load_pymatching_user_graph(uint64_t key)
+{
+    if (GL_DG_CACHE_DIR.empty())
+        return std::nullopt;
+
+    DG_CACHE_FILE f(dg_cache_path(DG_CACHE_KIND::PYMATCHING_USER_GRAPH, key));
+    if (!f.is_valid(DG_CACHE_KIND::PYMATCHING_USER_GRAPH, key))
+        return std::nullopt;
+
+    // the last vertex is the boundary:
+    const size_t num_nodes = f.header().num_vertices - 1;
+    const int32_t boundary_id = static_cast<int32_t>(num_nodes);
+
+    pm::UserGraph ug(num_nodes, f.header().num_observables);
+    auto edges = f.edges();
+
+    std::vector<size_t> observables;
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        const auto& e = edges[i];
+
+        observables.clear();
+        auto mask = f.observable_mask(i);
+        for (size_t w = 0; w < mask.size(); w++)
+        {
+            for (uint64_t x = mask[w]; x; x &= x-1)
+                observables.push_back(64*w + __builtin_ctzll(x));
+        }
+
+        if (e.dst == boundary_id)
+            ug.add_or_merge_boundary_edge(e.src, observables, e.weight, e.error_probability);
+        else
+            ug.add_or_merge_edge(e.src, e.dst, observables, e.weight, e.error_probability);
+    }
+    ug.loaded_from_dem_without_correlations = true;
+
+    return ug;
+}
+
+void
+store_pymatching_user_graph(uint64_t key, pm::UserGraph& ug)
+{
+    if (GL_DG_CACHE_DIR.empty())
+        return;
+
+    const size_t num_nodes = ug.nodes.size();
+    const size_t num_observables = ug.get_num_observables();
+    const uint32_t obs_words = _obs_words(num_observables);
+
+    std::vector<DG_CACHE_VERTEX> vertices(num_nodes+1);
+    for (size_t i = 0; i <= num_nodes; i++)
+        vertices[i].id = i;
+    vertices[num_nodes].is_boundary = 1;
+
+    std::vector<DG_CACHE_EDGE> edges;
+    std::vector<uint64_t> obs_masks(ug.edges.size() * obs_words, 0);
+    edges.reserve(ug.edges.size());
+    for (const auto& e : ug.edges)
+    {
+        uint64_t* mask = obs_masks.data() + edges.size()*obs_words;
+        for (auto obs_id : e.observable_indices)
+            mask[obs_id / 64] ^= 1ull << (obs_id % 64);
+
+        DG_CACHE_EDGE ce{};
+        ce.src = e.node1;
+        ce.dst = (e.node2 == SIZE_MAX) ? num_nodes : e.node2;
+        ce.error_probability = e.error_probability;
+        ce.weight = e.weight;
+        edges.push_back(ce);
+    }
+
+    _write_cache_file(DG_CACHE_KIND::PYMATCHING_USER_GRAPH, key, vertices, edges, obs_masks, num_observables, obs_words);
+}
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+}   // namespace io
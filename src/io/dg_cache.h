@@ -0,0 +1,150 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ * */
+
+#ifndef IO_DG_CACHE_h
+#define IO_DG_CACHE_h
+
+#include "decoding_graph.h"
+
+#include <stim/circuit/circuit.h>
+#include <stim/util_top/circuit_to_dem.h>
+
+#include <pymatching/sparse_blossom/driver/user_graph.h>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Directory for decoding graph caches. Caching is disabled if this is empty.
+extern std::string GL_DG_CACHE_DIR;
+
+namespace io
+{
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+/*
+ * On-disk format for a finished decoding graph. The file is laid out as:
+ *
+ *      DG_CACHE_HEADER
+ *      DG_CACHE_VERTEX[num_vertices]
+ *      DG_CACHE_EDGE[num_edges]
+ *      uint64_t[num_edges * obs_words]             (observable mask of each edge)
+ *
+ * All sections are 8-byte aligned, so they can be read directly from the file buffer. The
+ * decoders build their own graph from the file, so each process keeps its own copy.
+ * Edges are stored in insertion order, so rebuilding a graph from the file
+ * reproduces the original adjacency order (and hence identical decoding behavior).
+ * */
+
+constexpr uint32_t DG_CACHE_MAGIC{0x43474451};  // "QDGC"
+constexpr uint32_t DG_CACHE_VERSION{3};
+
+enum class DG_CACHE_KIND : uint32_t
+{
+    SC_DECODING_GRAPH = 1,      // `SC_DECODING_GRAPH` after `quantize_all_edge_weights`
+    PYMATCHING_USER_GRAPH = 2   // `pm::UserGraph` as built by `detector_error_model_to_user_graph`
+};
+
+struct DG_CACHE_HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint32_t obs_words;
+
+    uint64_t key;
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint64_t num_observables;
+};
+
+struct DG_CACHE_VERTEX
+{
+    int32_t id;
+    int32_t base_detector_id;
+    int32_t round_id;
+    uint8_t color;
+    uint8_t is_flag;
+    uint8_t is_boundary;
+    uint8_t _pad{0};
+};
+
+struct DG_CACHE_EDGE
+{
+    int32_t  src;
+    int32_t  dst;
+    double   error_probability;
+    double   weight;  // only used by `PYMATCHING_USER_GRAPH`
+    int16_t  quantized_weight;
+    uint16_t _pad[3]{};
+};
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+/*
+ * Read-only view of a cache file (the file is read into memory in one call).
+ * */
+
+class DG_CACHE_FILE
+{
+private:
+    std::vector<uint64_t> data_;
+    size_t                size_{0};
+public:
+    DG_CACHE_FILE(const std::string& path);
+    DG_CACHE_FILE(const DG_CACHE_FILE&) =delete;
+
+    bool is_open() const { return !data_.empty(); }
+
+    // returns true if the header is consistent with `kind`, `key`, and the file size:
+    bool is_valid(DG_CACHE_KIND, uint64_t key) const;
+
+    const DG_CACHE_HEADER& header() const { return *reinterpret_cast<const DG_CACHE_HEADER*>(data_.data()); }
+
+    std::span<const DG_CACHE_VERTEX>    vertices() const;
+    std::span<const DG_CACHE_EDGE>      edges() const;
+    std::span<const uint64_t>           observable_mask(size_t edge_idx) const;
+private:
+    template <class T> const T* section_at(size_t byte_offset) const
+    {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(data_.data()) + byte_offset);
+    }
+
+    size_t vertex_section_offset() const;
+    size_t edge_section_offset() const;
+    size_t obs_section_offset() const;
+    size_t expected_file_size() const;
+};
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+// hash of the circuit text and DEM options (FNV-1a):
+uint64_t dg_cache_key(const stim::Circuit&, const stim::DemOptions&, DG_CACHE_KIND);
+
+std::string dg_cache_path(DG_CACHE_KIND, uint64_t key);
+
+/*
+ * `load_*` functions return `std::nullopt`/`nullptr` if the cache is disabled, missing, or stale.
+ * `store_*` functions are no-ops if the cache is disabled. Files are written to a temporary path and
+ * renamed, so concurrent readers never observe a partially written cache.
+ * */
+
+SC_DECODING_GRAPH* load_sc_decoding_graph(uint64_t key);
+void               store_sc_decoding_graph(uint64_t key, const SC_DECODING_GRAPH&, size_t num_observables);
+
+std::optional<pm::UserGraph> load_pymatching_user_graph(uint64_t key);
+void                         store_pymatching_user_graph(uint64_t key, pm::UserGraph&);
+
+////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////
+
+}   // namespace io
+
+#endif
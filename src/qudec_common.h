@@ -40,6 +40,48 @@ fpdiv(INTA a, INTB b)
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 
+/*
+ * Prints the logical X/Z error counts (if `conf.observable_basis` is set), and the errors of
+ * each observable and each joint failure pattern (if there is more than one observable).
+ * */
+
+inline void
+print_observable_stats(std::ostream& out, const DECODER_STATS& stats, const DECODER_EVAL_CONFIG& conf)
+{
+    const auto& basis = conf.observable_basis;
+    if (basis.find('X') != std::string::npos)
+    {
+        print_stat(out, "LOGICAL_X_ERRORS", stats.x_errors);
+        print_stat(out, "LOGICAL_X_ERROR_RATE", fpdiv(stats.x_errors, stats.trials));
+    }
+    if (basis.find('Z') != std::string::npos)
+    {
+        print_stat(out, "LOGICAL_Z_ERRORS", stats.z_errors);
+        print_stat(out, "LOGICAL_Z_ERROR_RATE", fpdiv(stats.z_errors, stats.trials));
+    }
+
+    if (stats.errors_by_observable.size() > 1)
+    {
+        for (size_t o = 0; o < stats.errors_by_observable.size(); o++)
+            print_stat(out, "LOGICAL_ERRORS_L" + std::to_string(o), stats.errors_by_observable[o]);
+
+        // joint failures, i.e. "JOINT_ERRORS_L0_L2" is the number of shots where exactly L0 and L2 failed:
+        for (const auto& [pattern, count] : stats.errors_by_pattern)
+        {
+            std::string name{"JOINT_ERRORS"};
+            for (size_t o = 0; o < 64; o++)
+            {
+                if ((pattern >> o) & 1)
+                    name += "_L" + std::to_string(o);
+            }
+            print_stat(out, name, count);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
 template <class IMPL> void
 print_decoder_stats(std::ostream& out, const IMPL& dec)
 {
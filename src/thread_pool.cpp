@@ -0,0 +1,94 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#include "thread_pool.h"
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+THREAD_POOL::THREAD_POOL(size_t num_threads)
+{
+    for (size_t t = 1; t < num_threads; t++)
+        workers_.emplace_back([this, t] () { worker_loop(t); });
+}
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& th : workers_)
+        th.join();
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+THREAD_POOL::parallel_for(size_t count, const task_type& fn)
+{
+    if (workers_.empty() || count <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            fn(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        task_ = &fn;
+        task_count_ = count;
+        next_index_.store(0, std::memory_order_relaxed);
+        workers_busy_ = workers_.size();
+        generation_++;
+    }
+    start_cv_.notify_all();
+
+    run_tasks(0);
+
+    // wait for the workers to finish their last task:
+    std::unique_lock<std::mutex> lk(mtx_);
+    done_cv_.wait(lk, [this] () { return workers_busy_ == 0; });
+    task_ = nullptr;
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+void
+THREAD_POOL::worker_loop(size_t worker_id)
+{
+    uint64_t seen_generation{0};
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            start_cv_.wait(lk, [this, seen_generation] () { return stop_ || generation_ != seen_generation; });
+            if (stop_)
+                return;
+            seen_generation = generation_;
+        }
+
+        run_tasks(worker_id);
+
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (--workers_busy_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+}
+
+void
+THREAD_POOL::run_tasks(size_t worker_id)
+{
+    for (size_t i = next_index_.fetch_add(1); i < task_count_; i = next_index_.fetch_add(1))
+        (*task_)(i, worker_id);
+}
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+/*
+ *  author: Suhas Vittal
+ *  date:   18 October 2026
+ */
+
+#ifndef THREAD_POOL_h
+#define THREAD_POOL_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+/*
+ * A small fixed-size pool for fork-join loops inside a single decode. The workers sleep
+ * between calls to `parallel_for`, and the calling thread also takes part in the loop, so a
+ * pool of `n` threads spawns `n-1` workers.
+ *
+ * `parallel_for` is not reentrant: only one loop can run on a pool at a time.
+ * */
+
+class THREAD_POOL
+{
+public:
+    // `fn(index, worker_id)`, where `worker_id < num_threads()` (the caller is worker 0)
+    using task_type = std::function<void(size_t, size_t)>;
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex              mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+    const task_type*    task_{nullptr};
+    size_t              task_count_{0};
+    std::atomic<size_t> next_index_{0};
+    size_t              workers_busy_{0};
+    uint64_t            generation_{0};
+    bool                stop_{false};
+public:
+    THREAD_POOL(size_t num_threads);
+    THREAD_POOL(const THREAD_POOL&) =delete;
+    ~THREAD_POOL();
+
+    // runs `fn(i, worker_id)` for all `i` in [0, count) and returns once all calls finish.
+    void parallel_for(size_t count, const task_type& fn);
+
+    size_t num_threads() const { return workers_.size()+1; }
+private:
+    void worker_loop(size_t worker_id);
+    void run_tasks(size_t worker_id);
+};
+
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+
+#endif  // THREAD_POOL_h